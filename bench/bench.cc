@@ -0,0 +1,202 @@
+#include "../src/tools/tools.h"
+#include "../src/maquinaTuring/maquinaTuring.h"
+#include "../src/motor/motor.h"
+#include "../src/motorBloques/motorBloques.h"
+#include "../src/motorCarriles/motorCarriles.h"
+#include <chrono>
+#include <iomanip> // Para setw
+#include <iostream>
+#include <random> // Para mt19937
+
+using namespace std;
+
+/**
+ * @brief Genera una máquina de N cintas que copia la entrada en todas las cintas y después
+ *        recorre las cintas de un extremo a otro indefinidamente
+ * @param numCintas Número de cintas
+ * @param a Primer símbolo de la entrada
+ * @param b Segundo símbolo de la entrada
+ * @param relleno Símbolos sin uso que se añaden delante de a y b (más de 256 obligan a usar códigos de 16 bits)
+ * @return Definición con el formato de /data
+ */
+string maquinaVaiven(int numCintas, const string& a = "a", const string& b = "b", int relleno = 0) {
+  ostringstream os;
+  string simbolos;
+  for (int i = 0; i < relleno; ++i) simbolos += "r" + to_string(i) + " ";
+  simbolos += a + " " + b;
+  os << "q0 q1 q2 q3\n" << simbolos << "\n" << simbolos << " .\nq0\n.\nq3\n" << numCintas << endl;
+  auto transicion = [&](const string& actual, const string& primera, const string& resto, const string& siguiente, const string& escritura, char movimiento) {
+    os << actual;
+    for (int i = 0; i < numCintas; ++i) os << " " << (i == 0 ? primera : resto);
+    os << " " << siguiente;
+    for (int i = 0; i < numCintas; ++i) os << " " << escritura << " " << movimiento;
+    os << endl;
+  };
+  for (const string& s : {a, b}) {
+    transicion("q0", s, numCintas == 1 ? s : ".", "q0", s, 'R'); // Copio la entrada
+    transicion("q1", s, s, "q1", s, 'L');                         // Recorrido hacia la izquierda
+    transicion("q2", s, s, "q2", s, 'R');                         // Recorrido hacia la derecha
+  }
+  transicion("q0", ".", ".", "q1", ".", 'L');
+  transicion("q1", ".", ".", "q2", ".", 'R');
+  transicion("q2", ".", ".", "q1", ".", 'L');
+  return os.str();
+}
+
+/**
+ * @brief Genera la entrada de las medidas: 1000 símbolos, uno de cada tres es a
+ * @param separador Separador entre símbolos (espacio si los símbolos tienen varios caracteres)
+ */
+string entradaVaiven(const string& a, const string& b, const string& separador) {
+  string entrada;
+  for (int i = 0; i < 1000; ++i) entrada += (i > 0 ? separador : "") + ((i % 3 == 0) ? a : b);
+  return entrada;
+}
+
+/**
+ * @brief Genera una máquina de una cinta que va al final de la entrada, vuelve al principio y
+ *        acepta si el primer símbolo es a (unos 2n pasos por cadena)
+ * @return Definición con el formato de /data
+ */
+string maquinaIdaVuelta() {
+  return "q0 q1 q2 q3\na b\na b .\nq0\n.\nq3\n1\n"
+         "q0 a q0 a R\nq0 b q0 b R\nq0 . q1 . L\n"
+         "q1 a q1 a L\nq1 b q1 b L\nq1 . q2 . R\n"
+         "q2 a q3 a S\n";
+}
+
+/**
+ * @brief Genera una máquina de una cinta que cuenta en binario indefinidamente a partir de la entrada
+ * @return Definición con el formato de /data
+ */
+string maquinaContador() {
+  return "q0 q1 q2\n0 1\n0 1 .\nq0\n.\nq2\n1\n"
+         "q0 0 q0 0 R\nq0 1 q0 1 R\nq0 . q1 . L\n"  // Voy al final del número
+         "q1 1 q1 0 L\nq1 0 q0 1 R\nq1 . q0 1 R\n"; // Sumo 1 con acarreo
+}
+
+/**
+ * @brief Mide los pasos por segundo de una función que devuelve los pasos ejecutados (mejor de 3)
+ */
+template <typename Funcion>
+double medir(Funcion funcion) {
+  double mejor = 0;
+  for (int i = 0; i < 3; ++i) {
+    auto inicio = chrono::steady_clock::now();
+    long pasos = funcion();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    mejor = max(mejor, pasos / segundos);
+  }
+  return mejor;
+}
+
+/**
+ * @brief Compara los pasos por segundo de los núcleos especializados, del bucle genérico y de
+ *        MaquinaTuring (sin traza) para distinto número de cintas, y los de cada codificación de
+ *        los símbolos
+ * @param argc Número de argumentos
+ * @param argv [pasos por medida]
+ * @return Código de salida
+ */
+int main(int argc, char* argv[]) {
+  long pasos = argc > 1 ? stol(argv[1]) : 20000000;
+  string entrada = entradaVaiven("a", "b", "");
+
+  cout << "Pasos por segundo (millones), " << pasos << " pasos por medida" << endl;
+  cout << setw(7) << "Cintas" << setw(15) << "Especializado" << setw(10) << "Genérico" << setw(9) << "Mejora" << setw(15) << "MaquinaTuring" << endl;
+  for (int numCintas : {1, 2, 3, 4, 6, 8, 10}) {
+    string definicion = maquinaVaiven(numCintas);
+    Motor motor = Motor::desdeMemoria(definicion);
+    Contexto contexto;
+    double especializado = medir([&] { return motor.ejecutar(entrada, contexto, {pasos}).pasos; });
+    double generico = medir([&] { return motor.ejecutar(entrada, contexto, {.limitePasos = pasos, .nucleoGenerico = true}).pasos; });
+
+    istringstream flujo(definicion);
+    Tools datos = leerFlujo(flujo);
+    MaquinaTuring mt(datos.estados, datos.alfabetos.first, datos.alfabetos.second, datos.numCintas);
+    mt.setTraza(false);
+    mt.setLimitePasos(pasos / 10);
+    double referencia = medir([&] { mt.reiniciar(); mt.ejecutar(entrada); return mt.getPasos(); });
+    liberarEstados(datos);
+
+    cout << fixed << setprecision(1) << setw(7) << numCintas << setw(15) << especializado / 1e6 << setw(9) << generico / 1e6
+         << setw(8) << setprecision(2) << especializado / generico << "x" << setw(15) << setprecision(1) << referencia / 1e6 << endl;
+  }
+
+  // Lote de cadenas cortas: una a una con MaquinaTuring y con el Motor, y en carriles
+  vector<string> lote(100000);
+  mt19937 rng(42);
+  for (string& cadena : lote) {
+    cadena.resize(uniform_int_distribution<int>(4, 32)(rng));
+    for (char& simbolo : cadena) simbolo = "ab"[rng() & 1];
+  }
+  string definicion = maquinaIdaVuelta();
+  Motor motor = Motor::desdeMemoria(definicion);
+  istringstream flujo(definicion);
+  Tools datos = leerFlujo(flujo);
+  MaquinaTuring mt(datos.estados, datos.alfabetos.first, datos.alfabetos.second, datos.numCintas);
+  mt.setTraza(false);
+  double referencia = medir([&] {
+    long total = 0;
+    for (const string& cadena : lote) { mt.reiniciar(); mt.ejecutar(cadena); total += mt.getPasos(); }
+    return total;
+  });
+  liberarEstados(datos);
+  Contexto contexto;
+  double unaAUna = medir([&] {
+    long total = 0;
+    for (const string& cadena : lote) total += motor.ejecutar(cadena, contexto).pasos;
+    return total;
+  });
+  cout << endl << "Lote de " << lote.size() << " cadenas de 4 a 32 símbolos" << endl;
+  cout << setw(15) << "Motor" << setw(10) << "Mpasos/s" << setw(15) << "Mejora" << endl; // Mejora frente a MaquinaTuring
+  cout << setw(15) << "MaquinaTuring" << setw(10) << setprecision(1) << referencia / 1e6 << setw(14) << setprecision(2) << 1.0 << "x" << endl;
+  cout << setw(15) << "Motor" << setw(10) << setprecision(1) << unaAUna / 1e6 << setw(14) << setprecision(2) << unaAUna / referencia << "x" << endl;
+  for (size_t numCarriles : {8, 16, 32}) {
+    MotorCarriles carriles(motor, numCarriles);
+    double enCarriles = medir([&] {
+      long total = 0;
+      for (const ResultadoLote& resultado : carriles.ejecutarLote(lote)) total += resultado.pasos;
+      return total;
+    });
+    cout << setw(15) << "Carriles (" + to_string(numCarriles) + ")" << setw(10) << setprecision(1) << enCarriles / 1e6 << setw(14) << setprecision(2) << enCarriles / referencia << "x" << endl;
+  }
+
+  // Máquinas de una cinta con cómputos regulares, paso a paso y avanzando bloques memorizados
+  cout << endl << "Cómputos regulares de una cinta (millones de pasos por segundo)" << endl;
+  cout << setw(15) << "" << setw(10) << "Motor" << setw(12) << "Bloques" << setw(9) << "Mejora" << setw(10) << "Nodos" << endl;
+  struct Regular { string nombre, definicion, entrada; };
+  for (const Regular& r : {Regular{"contador", maquinaContador(), "0"}, Regular{"recorrido", maquinaVaiven(1), entrada}}) {
+    Motor motorRegular = Motor::desdeMemoria(r.definicion);
+    MotorBloques bloques(motorRegular);
+    Contexto contextoRegular;
+    double pasoAPaso = medir([&] { return motorRegular.ejecutar(r.entrada, contextoRegular, {pasos}).pasos; });
+    size_t nodos = 0;
+    double porBloques = medir([&] {
+      MemoriaBloques memoria; // Sin avances de las medidas anteriores
+      long total = bloques.ejecutar(r.entrada, memoria, {pasos}).pasos;
+      nodos = memoria.numNodos();
+      return total;
+    });
+    cout << setw(15) << r.nombre << fixed << setprecision(1) << setw(10) << pasoAPaso / 1e6 << setw(12) << porBloques / 1e6
+         << setw(8) << setprecision(0) << porBloques / pasoAPaso << "x" << setw(10) << nodos << endl;
+  }
+
+  // La misma máquina con símbolos de un carácter, de varios caracteres y detrás de 300 símbolos sin uso
+  cout << endl << setw(16) << "Símbolos" << setw(9) << "Anchura" << setw(10) << "1 cinta" << setw(10) << "4 cintas" << setw(16) << "Memoria (B)" << endl;
+  struct Codificacion { string nombre, a, b, separador; int relleno; };
+  for (const Codificacion& c : {Codificacion{"directos", "a", "b", "", 0}, Codificacion{"densos", "x1", "#L", " ", 0}, Codificacion{"densos+relleno", "x1", "#L", " ", 300}}) {
+    string entradaCodificada = entradaVaiven(c.a, c.b, c.separador);
+    double medidas[2];
+    size_t anchura = 0, memoria = 0;
+    for (int j = 0; j < 2; ++j) {
+      Motor motor = Motor::desdeMemoria(maquinaVaiven(j == 0 ? 1 : 4, c.a, c.b, c.relleno));
+      Contexto contexto;
+      medidas[j] = medir([&] { return motor.ejecutar(entradaCodificada, contexto, {pasos}).pasos; });
+      anchura = motor.tablaSimbolos().anchura();
+      memoria = motor.memoria();
+    }
+    cout << fixed << setprecision(1) << setw(15) << c.nombre << setw(6) << 8 * anchura << " bits" << setw(10) << medidas[0] / 1e6 << setw(10) << medidas[1] / 1e6 << setw(15) << memoria << endl;
+  }
+  return 0;
+}
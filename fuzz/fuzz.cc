@@ -0,0 +1,547 @@
+#include "../src/tools/tools.h"
+#include "../src/maquinaTuring/maquinaTuring.h"
+#include "../src/motor/motor.h"
+#include "../src/motorBloques/motorBloques.h"
+#include "../src/motorCarriles/motorCarriles.h"
+#include <filesystem> // Para crear el directorio de fallos
+#include <functional> // Para std::function
+#include <iostream>
+#include <limits> // Para numeric_limits
+#include <random> // Para mt19937
+
+using namespace std;
+
+/**
+ * @struct TransicionTexto
+ * @brief Transición de una máquina generada, tal y como se escribe en el fichero
+ */
+struct TransicionTexto {
+  string actual;
+  vector<string> lectura;
+  string siguiente;
+  vector<string> escritura;
+  vector<char> movimiento;
+};
+
+/**
+ * @struct DefinicionAleatoria
+ * @brief Máquina de Turing generada aleatoriamente junto con su cadena de entrada
+ */
+struct DefinicionAleatoria {
+  vector<string> estados;
+  vector<string> relleno; // Símbolos sin uso al principio de Σ y Γ, para que los demás tengan códigos de 16 bits
+  vector<string> sigma;
+  vector<string> gamma;
+  vector<string> finales;
+  int numCintas = 1;
+  vector<TransicionTexto> transiciones;
+  vector<string> cadena;
+  bool larga = false; // Generada con generar(rng, true): se compara con el Motor en lugar de con MaquinaTuring
+
+  string entrada() const;
+  string serializar() const;
+};
+
+/**
+ * @struct Observacion
+ * @brief Resultado observable de una ejecución: veredicto, pasos y cintas finales
+ */
+struct Observacion {
+  string veredicto; // "acepta", "rechaza", "limite" o el mensaje de la excepción
+  long pasos = 0;
+  vector<string> cintas;
+
+  friend bool operator==(const Observacion& a, const Observacion& b) = default;
+};
+
+/**
+ * @struct MotorPrueba
+ * @brief Motor que se compara contra el de referencia
+ */
+struct MotorPrueba {
+  string nombre;
+  function<Observacion(const string& definicion, const string& cadena, long limitePasos)> ejecutar;
+  bool enLargas = true; // Si también se prueba con las máquinas largas
+};
+
+/**
+ * @brief Escribe la cadena de entrada: carácter a carácter si todos los símbolos tienen un solo
+ *        carácter y separados por espacios si no
+ * @return Texto de la cadena
+ */
+string DefinicionAleatoria::entrada() const {
+  auto largo = [](const string& simbolo) { return simbolo.size() != 1; };
+  bool separar = any_of(relleno.begin(), relleno.end(), largo) || any_of(sigma.begin(), sigma.end(), largo) || any_of(gamma.begin(), gamma.end(), largo);
+  string texto;
+  for (size_t i = 0; i < cadena.size(); ++i) {
+    texto += (separar && i > 0 ? " " : "") + cadena[i];
+  }
+  return texto;
+}
+
+/**
+ * @brief Serializa la máquina en el formato de los ficheros de /data
+ * @return Texto de la definición
+ */
+string DefinicionAleatoria::serializar() const {
+  ostringstream os;
+  os << "# Máquina generada por turing-fuzz" << endl;
+  os << "# Cadena: " << entrada() << endl;
+  for (size_t i = 0; i < estados.size(); ++i) os << estados[i] << (i + 1 < estados.size() ? " " : "\n");
+  for (const string& simbolo : relleno) os << simbolo << " ";
+  for (size_t i = 0; i < sigma.size(); ++i) os << sigma[i] << (i + 1 < sigma.size() ? " " : "\n");
+  for (const string& simbolo : relleno) os << simbolo << " ";
+  for (size_t i = 0; i < gamma.size(); ++i) os << gamma[i] << (i + 1 < gamma.size() ? " " : "\n");
+  os << estados[0] << endl;
+  os << "." << endl;
+  for (size_t i = 0; i < finales.size(); ++i) os << finales[i] << (i + 1 < finales.size() ? " " : "");
+  os << endl << numCintas << endl;
+  for (const TransicionTexto& t : transiciones) {
+    os << t.actual;
+    for (const string& simbolo : t.lectura) os << " " << simbolo;
+    os << " " << t.siguiente;
+    for (int i = 0; i < numCintas; ++i) os << " " << t.escritura[i] << " " << t.movimiento[i];
+    os << endl;
+  }
+  return os.str();
+}
+
+/**
+ * @brief Convierte una cinta en texto recortando los blancos de los extremos
+ * @param cinta Códigos de las celdas de la cinta
+ * @param cabezal Posición del cabezal dentro de las celdas
+ * @param simbolos Tabla de símbolos de la máquina
+ * @return Texto con el cabezal marcado entre corchetes
+ */
+string normalizarCinta(const vector<Simbolo>& cinta, int cabezal, const TablaSimbolos& simbolos) {
+  int inicio = 0, fin = static_cast<int>(cinta.size()) - 1;
+  while (inicio < cabezal && cinta[inicio] == '.') inicio++;
+  while (fin > cabezal && cinta[fin] == '.') fin--;
+  string resultado;
+  for (int i = min(inicio, cabezal); i <= max(fin, cabezal); ++i) {
+    Simbolo simbolo = (i >= 0 && i < static_cast<int>(cinta.size())) ? cinta[i] : '.';
+    simbolos.anadir(resultado, simbolo, i == cabezal);
+  }
+  return resultado;
+}
+
+/**
+ * @brief Ejecuta la cadena en una MaquinaTuring recién construida
+ * @param reutilizar Si es true se ejecuta antes la misma cadena y se reinicia la máquina
+ * @return Resultado de la ejecución
+ */
+Observacion ejecutarReferencia(const string& definicion, const string& cadena, long limitePasos, bool reutilizar) {
+  istringstream flujo(definicion);
+  Tools datos = leerFlujo(flujo);
+  Observacion resultado;
+  {
+    MaquinaTuring mt(datos.estados, datos.alfabetos.first, datos.alfabetos.second, datos.numCintas);
+    mt.setTraza(false);
+    mt.setLimitePasos(limitePasos);
+    if (reutilizar) {
+      mt.ejecutar(cadena);
+      mt.reiniciar();
+    }
+    bool aceptada = mt.ejecutar(cadena);
+    resultado.veredicto = aceptada ? "acepta" : (mt.limiteAlcanzado() ? "limite" : "rechaza");
+    resultado.pasos = mt.getPasos();
+    for (const Cinta& cinta : mt.getCintas()) {
+      resultado.cintas.push_back(normalizarCinta(cinta.getCeldas(), cinta.getCabezal(), *datos.simbolos));
+    }
+  }
+  liberarEstados(datos);
+  return resultado;
+}
+
+/**
+ * @brief Ejecuta la cadena entregándola como una cinta ya escrita con los códigos de la máquina
+ *        y rodeada de blancos, como la salida de otra etapa de una tubería
+ * @return Resultado de la ejecución
+ */
+template <typename S>
+Resultado ejecutarTraspasada(const Motor& motor, const string& cadena, Contexto& contexto, const Opciones& opciones) {
+  vector<Simbolo> codigos;
+  motor.tablaSimbolos().codificar(cadena, codigos);
+  codigos.insert(codigos.begin(), 2, '.');
+  codigos.insert(codigos.end(), 3, '.');
+  vector<uint8_t> todos(size_t{1} << (8 * sizeof(S)), 1);
+  CintaSegmentada<S> cinta;
+  cinta.cargarCodigos(codigos.data(), codigos.size(), todos);
+  return motor.ejecutarCinta(cinta, contexto, opciones);
+}
+
+/**
+ * @brief Texto con el que se compara cada veredicto
+ */
+string describir(Veredicto veredicto) {
+  switch (veredicto) {
+    case Veredicto::Aceptada: return "acepta";
+    case Veredicto::Rechazada: return "rechaza";
+    case Veredicto::LimitePasos: return "limite";
+    case Veredicto::EntradaInvalida: return "entrada inválida";
+    case Veredicto::Cancelada: return "cancelada";
+  }
+  return "";
+}
+
+/**
+ * @brief Ejecuta la cadena con la API de Motor, reutilizando el contexto de otra ejecución
+ * @param opciones Opciones de la ejecución (límite de pasos y núcleo)
+ * @param traspasar Si es true la cadena se entrega como una cinta ya escrita (Motor::ejecutarCinta)
+ * @return Resultado de la ejecución
+ */
+Observacion ejecutarMotor(const string& definicion, const string& cadena, const Opciones& opciones, bool traspasar) {
+  Motor motor = Motor::desdeMemoria(definicion);
+  Contexto contexto;
+  motor.ejecutar("..", contexto, opciones); // Deja memoria de trabajo sucia a propósito
+  Resultado resultado;
+  if (traspasar) {
+    bool estrecha = motor.tablaSimbolos().anchura() == 1;
+    resultado = estrecha ? ejecutarTraspasada<char>(motor, cadena, contexto, opciones) : ejecutarTraspasada<uint16_t>(motor, cadena, contexto, opciones);
+  } else {
+    resultado = motor.ejecutar(cadena, contexto, opciones);
+  }
+
+  Observacion observacion;
+  observacion.veredicto = describir(resultado.veredicto);
+  observacion.pasos = resultado.pasos;
+  for (size_t i = 0; i < contexto.numCintas(); ++i) {
+    observacion.cintas.push_back(contexto.volcarCinta(i));
+  }
+  return observacion;
+}
+
+/**
+ * @brief Ejecuta la cadena en un lote de MotorCarriles detrás de otras entradas (prefijos de la
+ *        cadena), de forma que los carriles se vuelven a cargar antes de llegar a ella. El resto
+ *        del lote se compara con el Motor.
+ * @param numCarriles Carriles del motor
+ * @return Resultado de la ejecución de la cadena
+ */
+Observacion ejecutarCarriles(const string& definicion, const string& cadena, long limitePasos, size_t numCarriles) {
+  MotorCarriles carriles(Motor::desdeMemoria(definicion), numCarriles);
+  vector<string> lote;
+  for (size_t i = 0; i < numCarriles + 3; ++i) {
+    lote.push_back(cadena.substr(0, i % (cadena.size() + 1)));
+  }
+  lote.push_back(cadena);
+  Opciones opciones{limitePasos};
+  vector<ResultadoLote> resultados = carriles.ejecutarLote(lote, opciones, true);
+
+  Observacion observacion;
+  Contexto contexto;
+  for (size_t i = 0; i + 1 < lote.size(); ++i) {
+    Resultado esperado = carriles.motor().ejecutar(lote[i], contexto, opciones);
+    vector<string> cintas;
+    for (size_t j = 0; esperado.veredicto != Veredicto::EntradaInvalida && j < contexto.numCintas(); ++j) {
+      cintas.push_back(contexto.volcarCinta(j));
+    }
+    if (resultados[i].veredicto != esperado.veredicto || resultados[i].pasos != esperado.pasos || resultados[i].cintas != cintas) {
+      observacion.veredicto = "el lote no coincide con el Motor en la entrada '" + lote[i] + "'";
+      return observacion;
+    }
+  }
+  observacion.veredicto = describir(resultados.back().veredicto);
+  observacion.pasos = resultados.back().pasos;
+  observacion.cintas = resultados.back().cintas;
+  return observacion;
+}
+
+/**
+ * @brief Ejecuta la cadena en un MotorBloques después de ejecutar su primera mitad con la misma
+ *        memoria, de forma que se reutilizan bloques y avances de otra ejecución
+ * @param maxNodos Nodos a partir de los que se compacta el árbol
+ * @param tamCache Entradas de la caché de avances
+ * @return Resultado de la ejecución
+ */
+Observacion ejecutarBloques(const string& definicion, const string& cadena, long limitePasos, size_t maxNodos, size_t tamCache) {
+  MotorBloques bloques(Motor::desdeMemoria(definicion), maxNodos, tamCache);
+  MemoriaBloques memoria;
+  bloques.ejecutar(cadena.substr(0, cadena.size() / 2), memoria, Opciones{limitePasos});
+  Resultado resultado = bloques.ejecutar(cadena, memoria, Opciones{limitePasos});
+
+  Observacion observacion;
+  observacion.veredicto = describir(resultado.veredicto);
+  observacion.pasos = resultado.pasos;
+  for (size_t i = 0; i < memoria.numCintas(); ++i) {
+    observacion.cintas.push_back(memoria.volcarCinta(i));
+  }
+  return observacion;
+}
+
+/**
+ * @brief Ejecuta un motor capturando las excepciones como parte del resultado
+ */
+Observacion ejecutarSeguro(const MotorPrueba& motor, const string& definicion, const string& cadena, long limitePasos) {
+  try {
+    return motor.ejecutar(definicion, cadena, limitePasos);
+  } catch (const exception& e) {
+    Observacion resultado;
+    resultado.veredicto = string("excepción: ") + e.what();
+    return resultado;
+  }
+}
+
+/**
+ * @brief Lista de motores alternativos que deben coincidir con el de referencia
+ */
+vector<MotorPrueba> motoresAlternativos() {
+  return {
+    {"referencia reutilizada", [](const string& d, const string& c, long l) { return ejecutarReferencia(d, c, l, true); }, false},
+    {"motor", [](const string& d, const string& c, long l) { return ejecutarMotor(d, c, Opciones{l}, false); }, false},
+    {"motor (núcleo genérico)", [](const string& d, const string& c, long l) { return ejecutarMotor(d, c, Opciones{.limitePasos = l, .nucleoGenerico = true}, false); }},
+    {"motor (registro de vuelo)", [](const string& d, const string& c, long l) { return ejecutarMotor(d, c, Opciones{.limitePasos = l, .registroVuelo = 16}, false); }},
+    {"motor (cinta traspasada)", [](const string& d, const string& c, long l) { return ejecutarMotor(d, c, Opciones{l}, true); }},
+    {"carriles", [](const string& d, const string& c, long l) { return ejecutarCarriles(d, c, l, 8); }},
+    {"bloques", [](const string& d, const string& c, long l) { return ejecutarBloques(d, c, l, size_t{1} << 22, size_t{1} << 16); }},
+    {"bloques (memoria mínima)", [](const string& d, const string& c, long l) { return ejecutarBloques(d, c, l, 16, 4); }},
+  };
+}
+
+/**
+ * @brief Genera una máquina aleatoria válida y una cadena sobre su alfabeto de entrada
+ * @param rng Generador de números aleatorios
+ * @param larga Si es true, la máquina tiene una transición para cada estado y combinación de
+ *        símbolos leídos y la cadena tiene cientos de símbolos, de forma que las ejecuciones
+ *        duran hasta el límite de pasos o hasta llegar a un estado de aceptación
+ * @return Definición generada
+ */
+DefinicionAleatoria generar(mt19937& rng, bool larga) {
+  auto uniforme = [&rng](int a, int b) { return uniform_int_distribution<int>(a, b)(rng); };
+  const string letras = "abcdefghijklmnopqrstuvwxyz0123456789";
+  DefinicionAleatoria d;
+  d.larga = larga;
+
+  int numEstados = uniforme(2, 8);
+  for (int i = 0; i < numEstados; ++i) d.estados.push_back("q" + to_string(i));
+
+  // Símbolos de un carácter (codificación directa), de varios caracteres (códigos de 8 bits) o
+  // de varios caracteres detrás de más de 256 símbolos sin uso (códigos de 16 bits)
+  const vector<string> largos = {"x1", "#L", "ab", "zz9", "a", "b", "[]", "0"};
+  int tipoSimbolos = uniforme(0, 3);
+  int numSigma = uniforme(1, 4), numGamma = numSigma + uniforme(0, 3);
+  for (int i = 0; i < numGamma; ++i) {
+    string simbolo = tipoSimbolos < 2 ? string(1, letras[i]) : largos[i];
+    if (i < numSigma) d.sigma.push_back(simbolo);
+    d.gamma.push_back(simbolo);
+  }
+  d.gamma.push_back(".");
+  if (tipoSimbolos == 3) {
+    for (int i = 0; i < 300; ++i) d.relleno.push_back("r" + to_string(i));
+  }
+
+  // El estado inicial (q0) no puede ser de aceptación. En las máquinas largas casi ningún estado
+  // es de aceptación, y a los que lo son se llega con pocas transiciones
+  for (int i = 1; i < numEstados; ++i) {
+    if (uniforme(0, 3) == 0) d.finales.push_back(d.estados[i]);
+  }
+  if (d.finales.empty() || larga) d.finales = {d.estados.back()};
+
+  const string movimientos = "LRS";
+  if (larga) {
+    // Una o dos cintas, para que se usen los bloques (una cinta) y la tabla densa de los carriles
+    d.numCintas = uniforme(0, 3) == 0 ? 2 : 1;
+    for (int i = 0; i + 1 < numEstados; ++i) {
+      for (size_t a = 0; a < d.gamma.size(); ++a) {
+        for (size_t b = 0; b < (d.numCintas == 2 ? d.gamma.size() : 1); ++b) {
+          TransicionTexto t{d.estados[i], {d.gamma[a]}, d.estados[uniforme(0, numEstados - 1)], {}, {}};
+          if (d.numCintas == 2) t.lectura.push_back(d.gamma[b]);
+          if (t.siguiente == d.finales[0] && uniforme(0, 15) != 0) t.siguiente = d.estados[0];
+          for (int j = 0; j < d.numCintas; ++j) {
+            t.escritura.push_back(d.gamma[uniforme(0, d.gamma.size() - 1)]);
+            t.movimiento.push_back(movimientos[uniforme(0, 2)]);
+          }
+          d.transiciones.push_back(t);
+        }
+      }
+    }
+  } else {
+    d.numCintas = uniforme(0, 4) == 0 ? uniforme(5, 10) : uniforme(1, 4); // Hasta 10 para probar también el núcleo genérico
+    int numTransiciones = uniforme(1, 4 * numEstados);
+    for (int i = 0; i < numTransiciones; ++i) {
+      TransicionTexto t;
+      do {
+        t.actual = d.estados[uniforme(0, numEstados - 1)];
+      } while (find(d.finales.begin(), d.finales.end(), t.actual) != d.finales.end());
+      t.siguiente = d.estados[uniforme(0, numEstados - 1)];
+      for (int j = 0; j < d.numCintas; ++j) {
+        // Las cintas 2..n empiezan en blanco: se favorece leer blancos para que las transiciones se apliquen
+        bool blanco = j > 0 && uniforme(0, 1) == 0;
+        t.lectura.push_back(blanco ? "." : d.gamma[uniforme(0, d.gamma.size() - 1)]);
+        t.escritura.push_back(d.gamma[uniforme(0, d.gamma.size() - 1)]);
+        t.movimiento.push_back(movimientos[uniforme(0, 2)]);
+      }
+      d.transiciones.push_back(t);
+    }
+  }
+
+  int longitud = larga ? uniforme(100, 400) : uniforme(0, 12);
+  for (int i = 0; i < longitud; ++i) d.cadena.push_back(d.sigma[uniforme(0, d.sigma.size() - 1)]);
+  return d;
+}
+
+/**
+ * @brief Motor de referencia de una definición. MaquinaTuring amplía su cinta por la izquierda
+ *        celda a celda, así que las máquinas largas se comparan con el Motor, que a su vez se
+ *        compara con MaquinaTuring en todas las demás
+ */
+MotorPrueba referencia(const DefinicionAleatoria& d) {
+  if (d.larga) {
+    return {"motor", [](const string& def, const string& c, long l) { return ejecutarMotor(def, c, Opciones{l}, false); }};
+  }
+  return {"referencia", [](const string& def, const string& c, long l) { return ejecutarReferencia(def, c, l, false); }};
+}
+
+/**
+ * @brief Comprueba si la definición hace discrepar al motor respecto al de referencia
+ */
+bool discrepa(const DefinicionAleatoria& d, const MotorPrueba& motor, long limitePasos) {
+  string definicion = d.serializar();
+  return !(ejecutarSeguro(referencia(d), definicion, d.entrada(), limitePasos) == ejecutarSeguro(motor, definicion, d.entrada(), limitePasos));
+}
+
+/**
+ * @brief Reduce una definición que discrepa eliminando transiciones, símbolos de la cadena,
+ *        estados, símbolos de relleno y símbolos de Γ mientras la discrepancia se mantenga
+ * @return Definición minimizada
+ */
+DefinicionAleatoria minimizar(DefinicionAleatoria d, const MotorPrueba& motor, long limitePasos) {
+  bool cambiado = true;
+  while (cambiado) {
+    cambiado = false;
+    for (size_t i = 0; i < d.transiciones.size(); ++i) {
+      DefinicionAleatoria candidata = d;
+      candidata.transiciones.erase(candidata.transiciones.begin() + i);
+      if (discrepa(candidata, motor, limitePasos)) { d = candidata; cambiado = true; --i; }
+    }
+    for (size_t i = 0; i < d.cadena.size(); ++i) {
+      DefinicionAleatoria candidata = d;
+      candidata.cadena.erase(candidata.cadena.begin() + i);
+      if (discrepa(candidata, motor, limitePasos)) { d = candidata; cambiado = true; --i; }
+    }
+    // Estados que no aparecen en ninguna transición (el inicial siempre se conserva)
+    for (size_t i = 1; i < d.estados.size(); ++i) {
+      const string estado = d.estados[i];
+      bool usado = any_of(d.transiciones.begin(), d.transiciones.end(), [&](const TransicionTexto& t) { return t.actual == estado || t.siguiente == estado; });
+      if (usado || (d.finales.size() == 1 && d.finales[0] == estado)) continue;
+      DefinicionAleatoria candidata = d;
+      candidata.estados.erase(candidata.estados.begin() + i);
+      erase(candidata.finales, estado);
+      if (discrepa(candidata, motor, limitePasos)) { d = candidata; cambiado = true; --i; }
+    }
+    if (!d.relleno.empty()) {
+      DefinicionAleatoria candidata = d;
+      candidata.relleno.clear();
+      if (discrepa(candidata, motor, limitePasos)) { d = candidata; cambiado = true; }
+    }
+    // Símbolos de Γ que no son de entrada ni aparecen en las transiciones
+    for (size_t i = 0; i < d.gamma.size(); ++i) {
+      const string simbolo = d.gamma[i];
+      bool usado = simbolo == "." || find(d.sigma.begin(), d.sigma.end(), simbolo) != d.sigma.end() || any_of(d.transiciones.begin(), d.transiciones.end(), [&](const TransicionTexto& t) {
+        return find(t.lectura.begin(), t.lectura.end(), simbolo) != t.lectura.end() || find(t.escritura.begin(), t.escritura.end(), simbolo) != t.escritura.end();
+      });
+      if (usado) continue;
+      DefinicionAleatoria candidata = d;
+      candidata.gamma.erase(candidata.gamma.begin() + i);
+      if (discrepa(candidata, motor, limitePasos)) { d = candidata; cambiado = true; --i; }
+    }
+  }
+  return d;
+}
+
+/**
+ * @brief Ejecuta con MotorBloques y poca memoria un contador binario que no sale de su entrada
+ *        durante millones de pasos (todo el cómputo es un único avance de la raíz), y comprueba
+ *        que coincide con el Motor y que el árbol no pasa del máximo de nodos durante el avance
+ * @return true si el resultado coincide y se respeta el máximo de nodos
+ */
+bool comprobarMaximoNodos() {
+  const string definicion = "q0 q1 q2\n0 1\n0 1 .\nq0\n.\nq2\n1\n"
+                            "q0 0 q0 0 R\nq0 1 q0 1 R\nq0 . q1 . L\n" // Voy al final del número
+                            "q1 1 q1 0 L\nq1 0 q0 1 R\n";             // Sumo 1 sin ampliar el número
+  const size_t maxNodos = size_t{1} << 10;
+  const Opciones opciones{10000000};
+  const string entrada(48, '0');
+  MotorBloques bloques(Motor::desdeMemoria(definicion), maxNodos, size_t{1} << 12);
+  MemoriaBloques memoria;
+  Resultado obtenido = bloques.ejecutar(entrada, memoria, opciones);
+  Contexto contexto;
+  Resultado esperado = bloques.motor().ejecutar(entrada, contexto, opciones);
+  // Al interrumpir un avance se crean como mucho los nodos del camino hasta la raíz
+  size_t margen = 2 * MemoriaBloques::MAX_NIVELES;
+  bool correcto = obtenido.veredicto == esperado.veredicto && obtenido.pasos == esperado.pasos && memoria.volcarCinta(0) == contexto.volcarCinta(0);
+  if (!correcto || memoria.picoNodos() > maxNodos + margen) {
+    cerr << "MotorBloques con " << maxNodos << " nodos como máximo: " << (correcto ? "" : "no coincide con el Motor, ") << "ha llegado a " << memoria.picoNodos() << " nodos" << endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Lee un argumento numérico no negativo
+ * @param texto Argumento
+ * @param valor Valor leído
+ * @return false si el argumento no es un número no negativo que cabe en T
+ */
+template <typename T>
+bool leerNumero(const string& texto, T& valor) {
+  if (texto.empty() || texto.find_first_not_of("0123456789") != string::npos) return false;
+  try {
+    unsigned long long numero = stoull(texto);
+    if (numero > static_cast<unsigned long long>(numeric_limits<T>::max())) return false;
+    valor = static_cast<T>(numero);
+    return true;
+  } catch (const out_of_range&) {
+    return false;
+  }
+}
+
+/**
+ * @brief Programa de fuzzing diferencial entre el motor de referencia y los alternativos. Una de
+ *        cada CADA_LARGA máquinas es larga (cadena de cientos de símbolos y máquina que no se
+ *        detiene por falta de transiciones) y se ejecuta con al menos LIMITE_LARGAS pasos, para
+ *        llegar a los niveles altos de MotorBloques y a las recargas de MotorCarriles
+ * @param argc Número de argumentos
+ * @param argv [iteraciones] [semilla] [límite de pasos] [directorio de fallos]
+ * @return 0 si no hay discrepancias, 1 en caso contrario
+ */
+int main(int argc, char* argv[]) {
+  constexpr long CADA_LARGA = 100;
+  constexpr long LIMITE_LARGAS = 1000000;
+  long iteraciones = 1000;
+  unsigned semilla = random_device{}();
+  long limitePasos = 10000;
+  string directorio = argc > 4 ? argv[4] : "data/fuzz";
+  if (argc > 5 || (argc > 1 && !leerNumero(argv[1], iteraciones)) || (argc > 2 && !leerNumero(argv[2], semilla)) || (argc > 3 && !leerNumero(argv[3], limitePasos))) {
+    cerr << "Uso: " << argv[0] << " [iteraciones] [semilla] [límite_pasos] [directorio_fallos]" << endl;
+    return 2;
+  }
+
+  cout << "Semilla: " << semilla << endl;
+  mt19937 rng(semilla);
+  vector<MotorPrueba> motores = motoresAlternativos();
+  int fallos = comprobarMaximoNodos() ? 0 : 1;
+  long largas = 0;
+
+  for (long i = 0; i < iteraciones; ++i) {
+    bool larga = i % CADA_LARGA == CADA_LARGA - 1;
+    long limite = larga ? max(limitePasos, LIMITE_LARGAS) : limitePasos;
+    largas += larga;
+    DefinicionAleatoria d = generar(rng, larga);
+    string definicion = d.serializar();
+    Observacion esperada = ejecutarSeguro(referencia(d), definicion, d.entrada(), limite);
+    for (const MotorPrueba& motor : motores) {
+      if ((larga && !motor.enLargas) || esperada == ejecutarSeguro(motor, definicion, d.entrada(), limite)) continue;
+
+      DefinicionAleatoria minima = minimizar(d, motor, limite);
+      filesystem::create_directories(directorio);
+      string fichero = directorio + "/fallo_" + to_string(semilla) + "_" + to_string(i) + ".txt";
+      ofstream(fichero) << minima.serializar();
+      cerr << "Discrepancia con el motor '" << motor.nombre << "' en la iteración " << i << ", guardada en " << fichero << endl;
+      fallos++;
+    }
+  }
+
+  cout << iteraciones << " máquinas probadas (" << largas << " largas) contra " << motores.size() << " motor(es), " << fallos << " discrepancia(s)." << endl;
+  return fallos == 0 ? 0 : 1;
+}
@@ -6,7 +6,7 @@
 ostream& operator<<(ostream& os, const Alfabeto& alfabeto) {
   os << "{";
   for (auto it = alfabeto.simbolos_.begin(); it != alfabeto.simbolos_.end(); ++it) {
-    os << *it;
+    os << alfabeto.tabla_->token(*it);
     if (next(it) != alfabeto.simbolos_.end()) {
       os << ", ";
     }
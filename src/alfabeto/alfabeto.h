@@ -1,5 +1,7 @@
 #pragma once
+#include "../simbolos/simbolos.h"
 #include <iostream>
+#include <memory> // Para shared_ptr
 #include <set>
 
 #ifndef ALFABETO_H
@@ -9,24 +11,28 @@ using namespace std;
 
 /**
  * @class Alfabeto
- * @brief Clase que representa un alfabeto de símbolos
+ * @brief Clase que representa un alfabeto de símbolos, guardados por su código en la tabla de
+ *        símbolos de la máquina
  */
 class Alfabeto {
   public:
     // Constructor y destructor
     Alfabeto() = default;
+    Alfabeto(shared_ptr<const TablaSimbolos> simbolos) : tabla_(std::move(simbolos)) {}
     ~Alfabeto() = default;
 
     // Métodos
-    inline void insertar(char simbolo) { simbolos_.insert(simbolo); }
-    inline bool pertenece(char simbolo) const { return simbolos_.find(simbolo) != simbolos_.end(); }
+    inline void insertar(Simbolo simbolo) { simbolos_.insert(simbolo); }
+    inline bool pertenece(Simbolo simbolo) const { return simbolos_.find(simbolo) != simbolos_.end(); }
     inline size_t size() const { return simbolos_.size(); }
+    inline const TablaSimbolos& getTabla() const { return *tabla_; }
 
     // Sobrecarga de operadores
     friend ostream& operator<<(ostream& os, const Alfabeto& alfabeto);
 
   private:
-    set<char> simbolos_;
+    set<Simbolo> simbolos_;
+    shared_ptr<const TablaSimbolos> tabla_;
 };
 
 #endif // ALFABETO_H
\ No newline at end of file
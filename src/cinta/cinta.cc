@@ -5,10 +5,10 @@
  * @param cadena Cadena a insertar
  * @return void
  */
-void Cinta::insertar(const string& cadena) {
-  for (char simbolo : cadena) {
+void Cinta::insertar(const vector<Simbolo>& cadena) {
+  for (Simbolo simbolo : cadena) {
     if (!pertenece(simbolo)) {
-      throw invalid_argument("El símbolo '" + string(1, simbolo) + "' no pertenece al alfabeto de la cinta.");
+      throw invalid_argument("El símbolo '" + string(alfabetoCinta_.getTabla().token(simbolo)) + "' no pertenece al alfabeto de la cinta.");
     } else {
       cinta_.push_back(simbolo);
     }
@@ -24,18 +24,18 @@ void Cinta::comprobarCabezal() {
     cinta_.insert(cinta_.begin(), '.'); // Añadir blanco si nos salimos por la izquierda
     cabezal_ = 0;
     desplazamiento_++;
-  } else if (cabezal_ >= cinta_.size()) {
+  } else if (static_cast<size_t>(cabezal_) >= cinta_.size()) {
     cinta_.push_back('.'); // Añadir blanco si nos salimos por la derecha
-    cabezal_ = cinta_.size() - 1;
+    cabezal_ = static_cast<int>(cinta_.size()) - 1;
     desplazamiento_++;
   }
 }
 
 /**
  * @brief Método para lee el simbolo en la posicion actual del cabezal
- * @return char simbolo en la posicion actual del cabezal
+ * @return Simbolo simbolo en la posicion actual del cabezal
  */
-char Cinta::leer() {
+Simbolo Cinta::leer() {
   comprobarCabezal(); // Compruebo el cabezal antes de leer
   return cinta_[cabezal_];
 }
@@ -45,7 +45,7 @@ char Cinta::leer() {
  * @param simbolo simbolo a escribir
  * @return void
  */
-void Cinta::escribir(char simbolo) {
+void Cinta::escribir(Simbolo simbolo) {
   comprobarCabezal(); // Compruebo el cabezal antes de escribir
   cinta_[cabezal_] = simbolo;
 }
@@ -73,12 +73,8 @@ void Cinta::moverIzquierda() {
  */
 ostream& operator<<(ostream& os, const Cinta& cinta) {
   string resultado;
-  for (int i = 0; i < cinta.cinta_.size(); ++i) {
-    if (i == cinta.cabezal_) {
-      resultado += "[" + string(1, cinta.cinta_[i]) + "]"; // Indicar la posicion del cabezal
-    } else {
-      resultado += string(1, cinta.cinta_[i]);
-    }
+  for (size_t i = 0; i < cinta.cinta_.size(); ++i) {
+    cinta.alfabetoCinta_.getTabla().anadir(resultado, cinta.cinta_[i], static_cast<int>(i) == cinta.cabezal_); // Indicar la posicion del cabezal
   }
   os << resultado;
   return os;
@@ -18,23 +18,25 @@ class Cinta {
     ~Cinta() = default;
 
     // Métodos para manipular la cinta
-    char leer();
-    void escribir(char simbolo);
+    Simbolo leer();
+    void escribir(Simbolo simbolo);
     void moverDerecha();
     void moverIzquierda();
     void comprobarCabezal();
-    void insertar(const string& cadena);
+    void insertar(const vector<Simbolo>& cadena);
     inline void limpiar() { cinta_.clear(); cabezal_ = 0; desplazamiento_ = 0; } // Limpia la cinta
-    inline bool pertenece(char simbolo) const { return alfabetoCinta_.pertenece(simbolo); }
+    inline bool pertenece(Simbolo simbolo) const { return alfabetoCinta_.pertenece(simbolo); }
 
     // Getters
     inline Alfabeto getAlfabeto() const { return alfabetoCinta_; }
+    inline const vector<Simbolo>& getCeldas() const { return cinta_; }
+    inline int getCabezal() const { return cabezal_; }
     
     // Sobrecarga de operadores
     friend ostream& operator<<(ostream& os, const Cinta& cinta);
 
   private:
-    vector<char> cinta_;
+    vector<Simbolo> cinta_;
     Alfabeto alfabetoCinta_;
     int cabezal_;
     int desplazamiento_;
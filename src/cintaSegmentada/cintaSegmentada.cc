@@ -0,0 +1,180 @@
+#include "cintaSegmentada.h"
+
+/**
+ * @brief Método para cargar la entrada en la cinta validando sus símbolos en la misma pasada
+ * @param entrada Cadena de entrada con un byte por símbolo (no se copia a ningún otro buffer intermedio)
+ * @param validos Tabla con los códigos que se admiten en la entrada
+ * @return true si todos los símbolos son válidos, false en caso contrario
+ */
+template <typename S>
+bool CintaSegmentada<S>::cargar(string_view entrada, const vector<uint8_t>& validos) {
+  propia_.resize(entrada.size());
+  bool valida = true;
+  for (size_t i = 0; i < entrada.size(); ++i) {
+    valida &= validos[codigoDe(entrada[i])];
+    propia_[i] = static_cast<S>(codigoDe(entrada[i]));
+  }
+  reiniciar(propia_.data(), propia_.size());
+  return valida;
+}
+
+/**
+ * @brief Método para cargar una entrada ya codificada validando sus símbolos en la misma pasada
+ * @param codigos Códigos de los símbolos de la entrada
+ * @param tam Número de símbolos
+ * @param validos Tabla con los códigos que se admiten en la entrada
+ * @return true si todos los símbolos son válidos, false en caso contrario
+ */
+template <typename S>
+bool CintaSegmentada<S>::cargarCodigos(const Simbolo* codigos, size_t tam, const vector<uint8_t>& validos) {
+  propia_.resize(tam);
+  bool valida = true;
+  for (size_t i = 0; i < tam; ++i) {
+    valida &= codigos[i] < validos.size() && validos[codigos[i]];
+    propia_[i] = static_cast<S>(codigos[i]);
+  }
+  reiniciar(propia_.data(), propia_.size());
+  return valida;
+}
+
+/**
+ * @brief Método para usar memoria externa como contenido inicial de la cinta, sin copiarla.
+ *        La memoria debe poder escribirse y seguir siendo válida mientras se use la cinta.
+ * @param datos Inicio de la memoria externa
+ * @param tam Número de celdas
+ * @param validos Tabla con los códigos que se admiten en la entrada
+ * @return true si todos los símbolos son válidos, false en caso contrario
+ */
+template <typename S>
+bool CintaSegmentada<S>::cargarExterna(S* datos, size_t tam, const vector<uint8_t>& validos) {
+  bool valida = true;
+  for (size_t i = 0; i < tam; ++i) {
+    valida &= validos[codigoDe(datos[i])];
+  }
+  reiniciar(datos, tam);
+  return valida;
+}
+
+/**
+ * @brief Método para vaciar los segmentos de crecimiento y colocar el cabezal al inicio de la entrada
+ * @param base Memoria con la entrada
+ * @param tam Número de celdas de la entrada
+ * @return void
+ */
+template <typename S>
+void CintaSegmentada<S>::reiniciar(S* base, size_t tam) {
+  base_ = base;
+  tamBase_ = tam;
+  izquierda_.clear();
+  derecha_.clear();
+  cabezal_ = 0;
+  if (tamBase_ == 0) {
+    derecha_.push_back('.'); // La cinta vacía contiene un blanco bajo el cabezal
+  }
+}
+
+/**
+ * @brief Método para mover el cabezal, añadiendo un blanco si se sale de las celdas usadas
+ * @param movimiento 'L' (izquierda), 'R' (derecha) o 'S' (sin movimiento)
+ * @return void
+ */
+template <typename S>
+void CintaSegmentada<S>::mover(char movimiento) {
+  if (movimiento == 'R') {
+    cabezal_++;
+    if (cabezal_ > ultimaCelda()) {
+      crecerDerecha();
+    }
+  } else if (movimiento == 'L') {
+    cabezal_--;
+    if (cabezal_ < primeraCelda()) {
+      crecerIzquierda();
+    }
+  }
+}
+
+/**
+ * @brief Método para usar como entrada el contenido actual de la cinta (por ejemplo, la salida de
+ *        otra máquina que se ha traspasado). El cabezal se coloca en la primera celda que no es
+ *        blanco y se validan las celdas hasta la última que no es blanco, sin copiarlas.
+ * @param validos Tabla con los códigos que se admiten en la entrada
+ * @return true si todos los símbolos son válidos, false en caso contrario
+ */
+template <typename S>
+bool CintaSegmentada<S>::prepararEntrada(const vector<uint8_t>& validos) {
+  auto [inicio, fin] = extremos();
+  bool valida = true;
+  for (long i = inicio; i <= fin; ++i) {
+    Simbolo codigo = codigoDe(celda(i));
+    valida &= codigo < validos.size() && validos[codigo];
+  }
+  cabezal_ = inicio <= fin ? inicio : -static_cast<long>(izquierda_.size());
+  return valida;
+}
+
+/**
+ * @brief Método para obtener la primera y la última celda que no son blanco
+ * @return Par (inicio, fin), con inicio > fin si la cinta está en blanco
+ */
+template <typename S>
+pair<long, long> CintaSegmentada<S>::extremos() const {
+  long inicio = -static_cast<long>(izquierda_.size()), fin = static_cast<long>(tamBase_ + derecha_.size()) - 1;
+  while (inicio <= fin && celda(inicio) == '.') inicio++;
+  while (fin >= inicio && celda(fin) == '.') fin--;
+  return {inicio, fin};
+}
+
+/**
+ * @brief Método para obtener el contenido de la cinta sin los blancos de los extremos
+ * @param simbolos Tabla de símbolos de la máquina
+ * @return Contenido de la cinta
+ */
+template <typename S>
+string CintaSegmentada<S>::contenido(const TablaSimbolos& simbolos) const {
+  string resultado;
+  copiarContenido(resultado, simbolos);
+  return resultado;
+}
+
+/**
+ * @brief Método para copiar el contenido de la cinta sin los blancos de los extremos
+ * @param destino Cadena donde se copia, reutilizando su memoria
+ * @param simbolos Tabla de símbolos de la máquina
+ * @return void
+ */
+template <typename S>
+void CintaSegmentada<S>::copiarContenido(string& destino, const TablaSimbolos& simbolos) const {
+  auto [inicio, fin] = extremos();
+  destino.clear();
+  destino.reserve(fin >= inicio ? fin - inicio + 1 : 0);
+  if (simbolos.directa()) {
+    for (long i = inicio; i <= fin; ++i) {
+      destino += static_cast<char>(celda(i)); // El código es el propio carácter
+    }
+    return;
+  }
+  for (long i = inicio; i <= fin; ++i) {
+    simbolos.anadir(destino, codigoDe(celda(i)));
+  }
+}
+
+/**
+ * @brief Método para volcar la cinta sin los blancos de los extremos, marcando el cabezal
+ * @param simbolos Tabla de símbolos de la máquina
+ * @return Texto con el cabezal entre corchetes
+ */
+template <typename S>
+string CintaSegmentada<S>::volcar(const TablaSimbolos& simbolos) const {
+  long inicio = -static_cast<long>(izquierda_.size()), fin = static_cast<long>(tamBase_ + derecha_.size()) - 1;
+  while (inicio < cabezal_ && celda(inicio) == '.') inicio++;
+  while (fin > cabezal_ && celda(fin) == '.') fin--;
+  string resultado;
+  for (long i = inicio; i <= fin; ++i) {
+    simbolos.anadir(resultado, codigoDe(celda(i)), i == cabezal_);
+  }
+  return resultado;
+}
+
+// Anchuras de símbolo que usan las máquinas
+template class CintaSegmentada<char>;
+template class CintaSegmentada<uint16_t>;
@@ -0,0 +1,72 @@
+#pragma once
+#include "../simbolos/simbolos.h"
+#include <string>
+#include <string_view>
+#include <utility> // Para pair
+#include <vector>
+
+#ifndef CINTASEGMENTADA_H
+#define CINTASEGMENTADA_H
+
+using namespace std;
+
+/**
+ * @class CintaSegmentada
+ * @brief Cinta infinita en ambas direcciones formada por tres segmentos: la zona donde se carga
+ *        la entrada y dos vectores que crecen hacia la izquierda y hacia la derecha. Al contrario
+ *        que Cinta, nunca desplaza las celdas existentes y reutiliza su memoria entre ejecuciones.
+ *        La zona de la entrada puede ser memoria propia o memoria externa (un fichero proyectado).
+ *        Al mover una cinta se traspasan sus segmentos sin copiar las celdas. Cada celda guarda el
+ *        código de un símbolo con la anchura de la máquina: S es char (8 bits) o uint16_t.
+ */
+template <typename S>
+class CintaSegmentada {
+  public:
+    // Constructor y destructor
+    CintaSegmentada() = default;
+    CintaSegmentada(CintaSegmentada&&) = default;
+    CintaSegmentada& operator=(CintaSegmentada&&) = default;
+    ~CintaSegmentada() = default;
+
+    // Métodos
+    bool cargar(string_view entrada, const vector<uint8_t>& validos); // Entrada con un byte por símbolo (codificación directa)
+    bool cargarCodigos(const Simbolo* codigos, size_t tam, const vector<uint8_t>& validos);
+    bool cargarExterna(S* datos, size_t tam, const vector<uint8_t>& validos);
+    bool prepararEntrada(const vector<uint8_t>& validos);
+    void mover(char movimiento);
+    inline S leer() const { return celda(cabezal_); }
+    inline void escribir(S simbolo) { celda(cabezal_) = simbolo; }
+    inline size_t celdasUsadas() const { return izquierda_.size() + tamBase_ + derecha_.size(); }
+    string contenido(const TablaSimbolos& simbolos) const; // Celdas usadas sin los blancos de los extremos
+    void copiarContenido(string& destino, const TablaSimbolos& simbolos) const; // Como contenido() pero reutilizando la memoria de destino
+    string volcar(const TablaSimbolos& simbolos) const; // Como contenido() pero conservando el cabezal, marcado entre corchetes
+
+    // Acceso directo para los núcleos de ejecución, que llevan el cabezal en variables locales
+    inline long getCabezal() const { return cabezal_; }
+    inline void setCabezal(long cabezal) { cabezal_ = cabezal; }
+    inline long primeraCelda() const { return -static_cast<long>(izquierda_.size()); }
+    inline long ultimaCelda() const { return static_cast<long>(tamBase_ + derecha_.size()) - 1; }
+    inline void crecerIzquierda() { izquierda_.push_back('.'); }
+    inline void crecerDerecha() { derecha_.push_back('.'); }
+    inline S& celda(long posicion) {
+      if (posicion >= 0) {
+        size_t p = static_cast<size_t>(posicion);
+        return p < tamBase_ ? base_[p] : derecha_[p - tamBase_];
+      }
+      return izquierda_[-posicion - 1];
+    }
+    inline S celda(long posicion) const { return const_cast<CintaSegmentada*>(this)->celda(posicion); }
+
+  private:
+    void reiniciar(S* base, size_t tam);
+    pair<long, long> extremos() const; // Primera y última celda que no son blanco
+
+    S* base_ = nullptr;   // Posiciones [0, tamBase_), apunta a propia_ o a memoria externa
+    size_t tamBase_ = 0;
+    vector<S> propia_;
+    vector<S> izquierda_; // Posición -1 - i en izquierda_[i]
+    vector<S> derecha_;   // Posición tamBase_ + i en derecha_[i]
+    long cabezal_ = 0;
+};
+
+#endif // CINTASEGMENTADA_H
@@ -0,0 +1,390 @@
+#include "enumerador.h"
+#include <algorithm>
+#include <atomic>
+#include <exception> // Para exception_ptr
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+constexpr uint64_t MAX_CADENAS = uint64_t{1} << 48; // Más cadenas no se pueden ejecutar en un tiempo razonable
+
+/**
+ * @brief Cuenta las cadenas sobre un alfabeto de longitud 0 a longitudMaxima
+ * @param base Tamaño del alfabeto
+ * @param longitudMaxima Longitud de las cadenas más largas
+ * @return Número de cadenas (0 si son más de MAX_CADENAS)
+ */
+uint64_t contarCadenas(uint64_t base, size_t longitudMaxima) {
+  if (base == 0) {
+    return 1; // Solo la cadena vacía
+  }
+  if (base == 1) {
+    return longitudMaxima < MAX_CADENAS ? longitudMaxima + 1 : 0; // Una cadena de cada longitud
+  }
+  uint64_t total = 0;
+  uint64_t deLongitud = 1;
+  for (size_t longitud = 0; longitud <= longitudMaxima; ++longitud) {
+    total += deLongitud;
+    if (total > MAX_CADENAS || (longitud < longitudMaxima && deLongitud > MAX_CADENAS / base)) {
+      return 0;
+    }
+    deLongitud *= base;
+  }
+  return total;
+}
+
+/**
+ * @brief Genera el siguiente número pseudoaleatorio de una secuencia splitmix64
+ * @param estado Estado de la secuencia, se actualiza
+ * @return Número pseudoaleatorio
+ */
+uint64_t siguienteAleatorio(uint64_t& estado) {
+  uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @brief Genera un número pseudoaleatorio uniforme en [0, n), descartando los valores que darían
+ *        más peso a los primeros restos
+ * @param estado Estado de la secuencia, se actualiza
+ * @param n Cota superior (mayor que 0)
+ * @return Número pseudoaleatorio menor que n
+ */
+uint64_t aleatorioMenor(uint64_t& estado, uint64_t n) {
+  const uint64_t umbral = (0 - n) % n; // 2^64 mod n
+  uint64_t x;
+  do {
+    x = siguienteAleatorio(estado);
+  } while (x < umbral);
+  return x % n;
+}
+
+/**
+ * @brief Orden de la enumeración: por longitud y, en cada longitud, en el orden de Σ
+ */
+bool antesEnumeracion(const vector<uint32_t>& a, const vector<uint32_t>& b) {
+  return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+} // namespace
+
+/**
+ * @brief Método para anotar el resultado de una cadena
+ * @param veredicto Forma en la que terminó la ejecución
+ * @param pasos Pasos de la ejecución
+ */
+void ResumenLongitud::anotar(Veredicto veredicto, long pasos) {
+  pasosMinimos = cadenas == 0 ? pasos : min(pasosMinimos, pasos);
+  pasosMaximos = cadenas == 0 ? pasos : max(pasosMaximos, pasos);
+  sumaPasos += static_cast<uint64_t>(pasos);
+  ++cadenas;
+  if (veredicto == Veredicto::Aceptada) {
+    ++aceptadas;
+  } else if (veredicto == Veredicto::LimitePasos) {
+    ++limitePasos;
+  } else {
+    ++rechazadas;
+  }
+}
+
+/**
+ * @brief Método para sumar a este resumen el de otras cadenas
+ * @param otro Resumen de las otras cadenas
+ */
+void ResumenLongitud::combinar(const ResumenLongitud& otro) {
+  if (otro.cadenas == 0) {
+    return;
+  }
+  pasosMinimos = cadenas == 0 ? otro.pasosMinimos : min(pasosMinimos, otro.pasosMinimos);
+  pasosMaximos = cadenas == 0 ? otro.pasosMaximos : max(pasosMaximos, otro.pasosMaximos);
+  sumaPasos += otro.sumaPasos;
+  cadenas += otro.cadenas;
+  aceptadas += otro.aceptadas;
+  rechazadas += otro.rechazadas;
+  limitePasos += otro.limitePasos;
+}
+
+/**
+ * @brief Constructor de la clase Enumerador
+ * @param motor Máquina cuyo lenguaje se enumera
+ */
+Enumerador::Enumerador(Motor motor) : carriles_(std::move(motor)), alfabeto_(carriles_.motor().alfabetoEntrada()) {}
+
+/**
+ * @brief Método para contar las cadenas sobre Σ de longitud 0 a longitudMaxima
+ * @param longitudMaxima Longitud de las cadenas más largas
+ * @return Número de cadenas (lanza invalid_argument si son más de MAX_CADENAS)
+ */
+uint64_t Enumerador::numCadenas(size_t longitudMaxima) const {
+  const uint64_t total = contarCadenas(alfabeto_.size(), longitudMaxima);
+  if (total == 0) {
+    throw invalid_argument("Hay demasiadas cadenas de longitud hasta " + to_string(longitudMaxima) + "; usa una muestra.");
+  }
+  return total;
+}
+
+/**
+ * @brief Método para obtener la cadena con un índice de la enumeración
+ * @param indice Posición de la cadena por longitud y, en cada longitud, en el orden de Σ
+ * @return Posición en Σ de cada símbolo de la cadena
+ */
+Enumerador::Digitos Enumerador::digitos(uint64_t indice) const {
+  const uint64_t base = alfabeto_.size();
+  if (base == 1) {
+    return Digitos(indice, 0); // La cadena i es la de longitud i
+  }
+  size_t longitud = 0;
+  for (uint64_t deLongitud = 1; indice >= deLongitud; deLongitud *= base) {
+    indice -= deLongitud;
+    ++longitud;
+  }
+  Digitos resultado(longitud);
+  for (size_t j = longitud; j-- > 0; indice /= base) {
+    resultado[j] = static_cast<uint32_t>(indice % base);
+  }
+  return resultado;
+}
+
+/**
+ * @brief Método para elegir las cadenas de una muestra: muestra cadenas distintas, todas con la
+ *        misma probabilidad, entre las de longitud 0 a longitudMaxima (todas si no hay tantas). Si
+ *        las cadenas se pueden contar, se eligen sus índices con el algoritmo de Floyd; si no, se
+ *        elige la longitud con probabilidad proporcional a sus |Σ|^longitud cadenas, después cada
+ *        símbolo, y se descartan las repetidas.
+ * @param opciones Opciones de la enumeración
+ * @return Cadenas de la muestra en el orden de la enumeración
+ */
+vector<Enumerador::Digitos> Enumerador::elegirMuestra(const OpcionesEnumeracion& opciones) const {
+  const uint64_t base = alfabeto_.size();
+  const uint64_t total = contarCadenas(base, opciones.longitudMaxima);
+  uint64_t estado = opciones.semilla;
+  vector<Digitos> muestra;
+
+  if (total > 0) {
+    vector<uint64_t> indices;
+    if (opciones.muestra >= total) {
+      indices.resize(total);
+      for (uint64_t i = 0; i < total; ++i) {
+        indices[i] = i;
+      }
+    } else {
+      unordered_set<uint64_t> elegidos;
+      elegidos.reserve(opciones.muestra);
+      for (uint64_t j = total - opciones.muestra; j < total; ++j) {
+        uint64_t indice = aleatorioMenor(estado, j + 1);
+        if (!elegidos.insert(indice).second) {
+          elegidos.insert(j);
+        }
+      }
+      indices.assign(elegidos.begin(), elegidos.end());
+      sort(indices.begin(), indices.end());
+    }
+    muestra.reserve(indices.size());
+    for (uint64_t indice : indices) {
+      muestra.push_back(digitos(indice));
+    }
+    return muestra;
+  }
+
+  // proporcion[l] = |Σ|^l / (cadenas de longitud 0 a l): probabilidad de que una cadena de longitud
+  // hasta l tenga longitud l. Con |Σ| > 1 converge a (|Σ| - 1) / |Σ| en unas 60 longitudes, así que
+  // solo se calcula hasta que deja de cambiar y las longitudes mayores usan el último valor. Con
+  // |Σ| = 1 (y más de MAX_CADENAS cadenas) todas las longitudes tienen la misma probabilidad.
+  vector<double> proporcion(1, 1.0);
+  while (base > 1 && proporcion.size() <= opciones.longitudMaxima) {
+    double siguiente = 1.0 / (1.0 + 1.0 / (static_cast<double>(base) * proporcion.back()));
+    if (siguiente == proporcion.back()) {
+      break;
+    }
+    proporcion.push_back(siguiente);
+  }
+  auto elegirLongitud = [&]() -> size_t {
+    if (base == 1) {
+      const uint64_t longitudes = static_cast<uint64_t>(opciones.longitudMaxima) + 1;
+      return longitudes == 0 ? siguienteAleatorio(estado) : aleatorioMenor(estado, longitudes); // 0 = 2^64 longitudes
+    }
+    size_t longitud = opciones.longitudMaxima;
+    while (longitud > 0 && static_cast<double>(siguienteAleatorio(estado) >> 11) * 0x1.0p-53 >= proporcion[min(longitud, proporcion.size() - 1)]) {
+      --longitud;
+    }
+    return longitud;
+  };
+  set<Digitos, bool (*)(const Digitos&, const Digitos&)> elegidas(antesEnumeracion);
+  while (elegidas.size() < opciones.muestra) {
+    size_t longitud = elegirLongitud();
+    Digitos cadena(longitud);
+    for (uint32_t& digito : cadena) {
+      digito = static_cast<uint32_t>(aleatorioMenor(estado, base));
+    }
+    elegidas.insert(std::move(cadena));
+  }
+  muestra.assign(elegidas.begin(), elegidas.end());
+  return muestra;
+}
+
+/**
+ * @brief Método para obtener las cadenas de un bloque de la enumeración. La cadena i es la i-ésima
+ *        por longitud y, en cada longitud, en el orden de Σ.
+ * @param inicio Índice de la primera cadena del bloque
+ * @param fin Índice siguiente a la última cadena del bloque
+ * @param cadenas Cadenas del bloque, se sobrescribe
+ */
+void Enumerador::cadenasBloque(uint64_t inicio, uint64_t fin, vector<Digitos>& cadenas) const {
+  const uint64_t base = alfabeto_.size();
+  cadenas.resize(fin - inicio);
+  Digitos actual = digitos(inicio);
+  for (uint64_t i = inicio; i < fin; ++i) {
+    cadenas[i - inicio] = actual;
+    // Siguiente cadena: se suma uno a los dígitos y, si todos vuelven a 0, se pasa a la longitud siguiente
+    size_t j = actual.size();
+    while (j > 0 && ++actual[j - 1] == base) {
+      actual[--j] = 0;
+    }
+    if (j == 0) {
+      actual.assign(actual.size() + 1, 0);
+    }
+  }
+}
+
+/**
+ * @brief Método para escribir una cadena con los símbolos de la máquina
+ * @param digitos Posición en Σ de cada símbolo
+ * @return Cadena de entrada (con los símbolos separados por espacios si tienen varios caracteres)
+ */
+string Enumerador::texto(const Digitos& digitos) const {
+  const TablaSimbolos& simbolos = carriles_.motor().tablaSimbolos();
+  string cadena;
+  for (uint32_t digito : digitos) {
+    simbolos.anadir(cadena, alfabeto_[digito]);
+  }
+  return cadena;
+}
+
+/**
+ * @brief Método para ejecutar todas las cadenas de la enumeración (o de la muestra)
+ * @param opciones Opciones de la enumeración
+ * @return Cadenas aceptadas y resumen por longitud
+ */
+ResultadoEnumeracion Enumerador::enumerar(const OpcionesEnumeracion& opciones) const {
+  if (opciones.limitePasos <= 0) {
+    throw invalid_argument("El límite de pasos de la enumeración debe ser mayor que 0.");
+  }
+  const vector<Digitos> muestra = opciones.muestra > 0 ? elegirMuestra(opciones) : vector<Digitos>{};
+  const uint64_t total = opciones.muestra > 0 ? muestra.size() : numCadenas(opciones.longitudMaxima);
+  const uint64_t numBloques = (total + TAM_BLOQUE - 1) / TAM_BLOQUE;
+  size_t numHilos = opciones.hilos > 0 ? opciones.hilos : max(1u, thread::hardware_concurrency());
+  numHilos = static_cast<size_t>(min<uint64_t>(numHilos, max<uint64_t>(numBloques, 1)));
+
+  /**
+   * @struct TrabajoHilo
+   * @brief Lo que ha ejecutado un hilo: el resumen de sus cadenas y las aceptadas de cada bloque
+   */
+  struct TrabajoHilo {
+    vector<ResumenLongitud> porLongitud; // Hasta la cadena más larga del hilo, no hasta longitudMaxima
+    vector<pair<uint64_t, vector<Digitos>>> aceptadas; // Por bloque, en el orden en que se tomaron
+    exception_ptr error;                               // Excepción que detuvo al hilo, si la hay
+  };
+  vector<TrabajoHilo> trabajos(numHilos);
+  atomic<uint64_t> siguienteBloque{0};
+  atomic<bool> fallo{false};
+  Opciones opcionesCadena;
+  opcionesCadena.limitePasos = opciones.limitePasos;
+
+  auto trabajar = [&](TrabajoHilo& trabajo) {
+    try {
+      vector<Digitos> cadenas;
+      vector<string> entradas;
+      for (uint64_t bloque; !fallo && (bloque = siguienteBloque.fetch_add(1)) < numBloques;) {
+        uint64_t inicio = bloque * TAM_BLOQUE;
+        uint64_t fin = min(total, inicio + TAM_BLOQUE);
+        if (opciones.muestra > 0) {
+          cadenas.assign(muestra.begin() + static_cast<ptrdiff_t>(inicio), muestra.begin() + static_cast<ptrdiff_t>(fin));
+        } else {
+          cadenasBloque(inicio, fin, cadenas);
+        }
+        entradas.resize(cadenas.size());
+        for (size_t i = 0; i < cadenas.size(); ++i) {
+          entradas[i] = texto(cadenas[i]);
+        }
+
+        vector<ResultadoLote> resultados = carriles_.ejecutarLote(entradas, opcionesCadena);
+        vector<Digitos> aceptadas;
+        for (size_t i = 0; i < cadenas.size(); ++i) {
+          if (cadenas[i].size() >= trabajo.porLongitud.size()) {
+            trabajo.porLongitud.resize(cadenas[i].size() + 1);
+          }
+          trabajo.porLongitud[cadenas[i].size()].anotar(resultados[i].veredicto, resultados[i].pasos);
+          if (resultados[i].veredicto == Veredicto::Aceptada) {
+            aceptadas.push_back(std::move(cadenas[i]));
+          }
+        }
+        if (!aceptadas.empty()) {
+          trabajo.aceptadas.emplace_back(bloque, std::move(aceptadas));
+        }
+      }
+    } catch (...) {
+      // Los demás hilos dejan de tomar bloques y enumerar relanza la excepción tras esperarlos
+      trabajo.error = current_exception();
+      fallo = true;
+    }
+  };
+
+  vector<thread> hilos;
+  try {
+    for (size_t i = 1; i < numHilos; ++i) {
+      hilos.emplace_back(trabajar, ref(trabajos[i]));
+    }
+  } catch (...) {
+    // Si no se puede crear un hilo, se espera a los ya creados antes de relanzar
+    trabajos[0].error = current_exception();
+    fallo = true;
+  }
+  if (!fallo) {
+    trabajar(trabajos[0]);
+  }
+  for (thread& hilo : hilos) {
+    hilo.join();
+  }
+  for (const TrabajoHilo& trabajo : trabajos) {
+    if (trabajo.error) {
+      rethrow_exception(trabajo.error);
+    }
+  }
+
+  // Reunir lo de todos los hilos en el orden de los bloques, que no depende de qué hilo tomó cada uno
+  ResultadoEnumeracion resultado;
+  vector<pair<uint64_t, vector<Digitos>>> bloques;
+  for (TrabajoHilo& trabajo : trabajos) {
+    if (trabajo.porLongitud.size() > resultado.porLongitud.size()) {
+      resultado.porLongitud.resize(trabajo.porLongitud.size());
+    }
+    for (size_t longitud = 0; longitud < trabajo.porLongitud.size(); ++longitud) {
+      resultado.porLongitud[longitud].combinar(trabajo.porLongitud[longitud]);
+    }
+    for (auto& bloque : trabajo.aceptadas) {
+      bloques.push_back(std::move(bloque));
+    }
+  }
+  for (const ResumenLongitud& resumen : resultado.porLongitud) {
+    resultado.total.combinar(resumen);
+  }
+  sort(bloques.begin(), bloques.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  vector<Digitos> aceptadas;
+  for (auto& bloque : bloques) {
+    for (Digitos& digitos : bloque.second) {
+      aceptadas.push_back(std::move(digitos));
+    }
+  }
+  resultado.aceptadas.reserve(aceptadas.size());
+  for (const Digitos& digitos : aceptadas) {
+    resultado.aceptadas.push_back(texto(digitos));
+  }
+  return resultado;
+}
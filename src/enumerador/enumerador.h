@@ -0,0 +1,90 @@
+#pragma once
+#include "../motor/motor.h"
+#include "../motorCarriles/motorCarriles.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef ENUMERADOR_H
+#define ENUMERADOR_H
+
+using namespace std;
+
+/**
+ * @struct OpcionesEnumeracion
+ * @brief Cadenas que se enumeran y cómo se ejecutan
+ */
+struct OpcionesEnumeracion {
+  size_t longitudMaxima = 0;  // Se enumeran las cadenas de longitud 0 a longitudMaxima
+  size_t muestra = 0;         // 0 = todas las cadenas; si no, número de cadenas aleatorias distintas
+  uint64_t semilla = 0;       // Semilla de la muestra
+  long limitePasos = 1000000; // Límite de pasos de cada cadena (mayor que 0: sin él, una cadena con la que la máquina no para detendría la enumeración)
+  size_t hilos = 0;           // 0 = uno por núcleo
+};
+
+/**
+ * @struct ResumenLongitud
+ * @brief Veredictos y pasos de las cadenas ejecutadas de una longitud (o de todas)
+ */
+struct ResumenLongitud {
+  size_t cadenas = 0;
+  size_t aceptadas = 0;
+  size_t rechazadas = 0;
+  size_t limitePasos = 0; // Cadenas que alcanzaron el límite de pasos
+  long pasosMinimos = 0;
+  long pasosMaximos = 0;
+  uint64_t sumaPasos = 0;
+
+  void anotar(Veredicto veredicto, long pasos);
+  void combinar(const ResumenLongitud& otro);
+  inline double pasosMedios() const { return cadenas == 0 ? 0.0 : static_cast<double>(sumaPasos) / static_cast<double>(cadenas); }
+};
+
+/**
+ * @struct ResultadoEnumeracion
+ * @brief Cadenas aceptadas y resumen por longitud de una enumeración
+ */
+struct ResultadoEnumeracion {
+  vector<string> aceptadas;            // Por longitud y, en cada longitud, en el orden de Σ (sin repetir)
+  vector<ResumenLongitud> porLongitud; // Indexado por la longitud, de 0 a la de la cadena ejecutada más larga
+  ResumenLongitud total;
+};
+
+/**
+ * @class Enumerador
+ * @brief Enumera el lenguaje de una máquina: ejecuta todas las cadenas sobre Σ hasta una longitud
+ *        (o una muestra aleatoria) repartidas en bloques entre varios hilos, que los ejecutan con el
+ *        mismo MotorCarriles (ejecutarLote es const y cada llamada tiene sus propios carriles).
+ *        Cada cadena de la enumeración se obtiene a partir de su índice y la muestra
+ *        se elige antes de repartirla, así que el resultado no depende del número de hilos ni del
+ *        orden en el que estos terminan sus bloques.
+ */
+class Enumerador {
+  public:
+    static constexpr size_t TAM_BLOQUE = 4096; // Cadenas que un hilo toma de cada vez
+
+    // Constructor y destructor
+    explicit Enumerador(Motor motor);
+    ~Enumerador() = default;
+
+    // Métodos (lanza invalid_argument si hay demasiadas cadenas que enumerar o el límite de pasos no es positivo)
+    ResultadoEnumeracion enumerar(const OpcionesEnumeracion& opciones) const;
+
+    // Getters
+    inline const vector<Simbolo>& alfabeto() const { return alfabeto_; }
+    inline const Motor& motor() const { return carriles_.motor(); }
+
+  private:
+    using Digitos = vector<uint32_t>; // Posición en Σ de cada símbolo de una cadena
+
+    uint64_t numCadenas(size_t longitudMaxima) const;
+    Digitos digitos(uint64_t indice) const;
+    vector<Digitos> elegirMuestra(const OpcionesEnumeracion& opciones) const;
+    void cadenasBloque(uint64_t inicio, uint64_t fin, vector<Digitos>& cadenas) const;
+    string texto(const Digitos& digitos) const;
+
+    MotorCarriles carriles_;
+    vector<Simbolo> alfabeto_;
+};
+
+#endif // ENUMERADOR_H
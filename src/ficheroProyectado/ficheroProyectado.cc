@@ -0,0 +1,74 @@
+#include "ficheroProyectado.h"
+#include <fcntl.h>    // Para open
+#include <stdexcept>  // Para las excepciones
+#include <sys/mman.h> // Para mmap
+#include <sys/stat.h> // Para fstat
+#include <unistd.h>   // Para close
+
+/**
+ * @brief Constructor que proyecta el fichero completo en memoria
+ * @param nombreFichero Nombre del fichero
+ */
+FicheroProyectado::FicheroProyectado(const string& nombreFichero) {
+  int fd = open(nombreFichero.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw runtime_error("No se pudo abrir el fichero: " + nombreFichero);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw runtime_error("No se pudo consultar el tamaño del fichero: " + nombreFichero);
+  }
+  tam_ = static_cast<size_t>(info.st_size);
+  if (tam_ > 0) {
+    void* proyeccion = mmap(nullptr, tam_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (proyeccion == MAP_FAILED) {
+      close(fd);
+      throw runtime_error("No se pudo proyectar en memoria el fichero: " + nombreFichero);
+    }
+    datos_ = static_cast<char*>(proyeccion);
+  }
+  close(fd); // La proyección sigue siendo válida sin el descriptor
+}
+
+/**
+ * @brief Operador de asignación por movimiento
+ */
+FicheroProyectado& FicheroProyectado::operator=(FicheroProyectado&& otro) noexcept {
+  if (this != &otro) {
+    liberar();
+    datos_ = otro.datos_;
+    tam_ = otro.tam_;
+    otro.datos_ = nullptr;
+    otro.tam_ = 0;
+  }
+  return *this;
+}
+
+/**
+ * @brief Método para aconsejar lectura secuencial (lectura anticipada agresiva)
+ * @return void
+ */
+void FicheroProyectado::accesoSecuencial() const {
+  if (datos_ != nullptr) madvise(datos_, tam_, MADV_SEQUENTIAL);
+}
+
+/**
+ * @brief Método para volver al acceso por defecto una vez terminada la lectura secuencial
+ * @return void
+ */
+void FicheroProyectado::accesoNormal() const {
+  if (datos_ != nullptr) madvise(datos_, tam_, MADV_NORMAL);
+}
+
+/**
+ * @brief Método para deshacer la proyección
+ * @return void
+ */
+void FicheroProyectado::liberar() {
+  if (datos_ != nullptr) {
+    munmap(datos_, tam_);
+  }
+  datos_ = nullptr;
+  tam_ = 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+
+#ifndef FICHEROPROYECTADO_H
+#define FICHEROPROYECTADO_H
+
+using namespace std;
+
+/**
+ * @class FicheroProyectado
+ * @brief Fichero proyectado en memoria con mmap privado: se puede escribir sobre él y el sistema
+ *        solo copia las páginas que se modifican, sin tocar el fichero en disco.
+ */
+class FicheroProyectado {
+  public:
+    // Constructor y destructor
+    FicheroProyectado() = default;
+    explicit FicheroProyectado(const string& nombreFichero);
+    FicheroProyectado(FicheroProyectado&& otro) noexcept { *this = std::move(otro); }
+    FicheroProyectado& operator=(FicheroProyectado&& otro) noexcept;
+    FicheroProyectado(const FicheroProyectado&) = delete;
+    FicheroProyectado& operator=(const FicheroProyectado&) = delete;
+    ~FicheroProyectado() { liberar(); }
+
+    // Getters
+    inline char* datos() const { return datos_; }
+    inline size_t size() const { return tam_; }
+
+    // Métodos
+    void accesoSecuencial() const; // Aviso al sistema de que se va a leer de principio a fin
+    void accesoNormal() const;      // Vuelvo al comportamiento por defecto tras la lectura secuencial
+    void liberar();
+
+  private:
+    char* datos_ = nullptr;
+    size_t tam_ = 0;
+};
+
+#endif // FICHEROPROYECTADO_H
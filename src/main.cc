@@ -1,19 +1,222 @@
 #include "tools/tools.h"
 #include "maquinaTuring/maquinaTuring.h"
+#include "motor/motor.h"
+#include "tuberia/tuberia.h"
+#include "enumerador/enumerador.h"
+#include <iomanip>
 #include <iostream>
+#include <limits> // Para numeric_limits
+#include <sys/resource.h> // Para getrusage
+#include <thread> // Para hardware_concurrency
 
 using namespace std;
 
+/**
+ * @struct ErrorArgumentos
+ * @brief Error en los argumentos del programa, tras el que se muestra el uso
+ */
+struct ErrorArgumentos : invalid_argument {
+  using invalid_argument::invalid_argument;
+};
+
+/**
+ * @brief Muestra las formas de invocar el programa
+ * @param programa Nombre con el que se invocó el programa
+ */
+void mostrarUso(const char* programa) {
+  cerr << "Uso: " << programa << " <fichero_entrada> [--entrada <fichero_cadena> [--limite <pasos>] [--registro <configuraciones>]]" << endl;
+  cerr << "     " << programa << " <fichero_entrada> --enumerar <longitud> [--muestra <cadenas>] [--semilla <semilla>] [--limite <pasos>] [--hilos <hilos>]" << endl;
+  cerr << "     " << programa << " --tuberia <fichero_entrada>[:cinta] ..." << endl;
+}
+
+/**
+ * @brief Lee el valor numérico de una opción
+ * @param opcion Nombre de la opción, para el mensaje de error
+ * @param texto Valor de la opción
+ * @param maximo Mayor valor admitido
+ * @return Valor leído (lanza ErrorArgumentos si no es un número entre 0 y maximo)
+ */
+template <typename T>
+T leerNumero(const string& opcion, const string& texto, T maximo = numeric_limits<T>::max()) {
+  if (!texto.empty() && texto.find_first_not_of("0123456789") == string::npos) {
+    try {
+      unsigned long long numero = stoull(texto);
+      if (numero <= static_cast<unsigned long long>(maximo)) {
+        return static_cast<T>(numero);
+      }
+    } catch (const out_of_range&) {
+      // Se informa abajo, como cualquier otro valor no válido
+    }
+  }
+  throw ErrorArgumentos("Valor no válido para " + opcion + ": " + texto);
+}
+
+/**
+ * @brief Ejecuta la máquina sobre una cadena almacenada en un fichero, proyectándolo en memoria
+ * @param nombreFichero Fichero con la definición de la máquina
+ * @param ficheroCadena Fichero con la cadena de entrada
+ * @param opciones Opciones de la ejecución (límite de pasos y registro de vuelo)
+ * @return Código de salida
+ */
+int ejecutarFichero(const string& nombreFichero, const string& ficheroCadena, const Opciones& opciones) {
+  Motor motor = Motor::desdeFichero(nombreFichero);
+  Contexto contexto;
+  Resultado resultado = motor.ejecutarFichero(ficheroCadena, contexto, opciones);
+
+  if (resultado.veredicto == Veredicto::EntradaInvalida) {
+    cerr << "Error: La cadena contiene símbolos que no pertenecen al alfabeto de entrada." << endl;
+    return 1;
+  }
+  struct rusage uso;
+  getrusage(RUSAGE_SELF, &uso);
+  if (resultado.veredicto == Veredicto::LimitePasos) {
+    cout << "Se ha alcanzado el límite de " << opciones.limitePasos << " pasos." << endl;
+  }
+  cout << "La cadena de " << ficheroCadena << (resultado.veredicto == Veredicto::Aceptada ? " pertenece" : " no pertenece") << " al lenguaje." << endl;
+  cout << "Pasos: " << resultado.pasos << endl;
+  cout << "Celdas usadas: " << resultado.celdasUsadas << endl;
+  cout << "Memoria de la máquina: " << motor.memoria() << " bytes" << endl;
+  cout << "Memoria máxima: " << uso.ru_maxrss << " KB" << endl;
+  return 0;
+}
+
+/**
+ * @brief Pasa cada línea de la entrada estándar por una tubería de máquinas y muestra la salida
+ *        de la última etapa (modo transductor si solo hay una máquina)
+ * @param especificaciones "fichero" o "fichero:cinta" de cada etapa
+ * @return Código de salida
+ */
+int ejecutarTuberia(const vector<string>& especificaciones) {
+  Tuberia tuberia = Tuberia::desdeFicheros(especificaciones);
+  vector<string> entradas;
+  string cadena;
+  while (getline(cin, cadena)) {
+    entradas.push_back(cadena);
+  }
+
+  vector<ResultadoTuberia> resultados = tuberia.ejecutarLote(entradas);
+  for (size_t i = 0; i < entradas.size(); ++i) {
+    const ResultadoTuberia& resultado = resultados[i];
+    if (resultado.veredicto == Veredicto::Aceptada) {
+      cout << entradas[i] << " -> " << resultado.salida << endl;
+    } else {
+      cout << entradas[i] << " -> no pertenece al lenguaje de la etapa " << resultado.etapa + 1 << endl;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Enumera el lenguaje de la máquina: muestra las cadenas aceptadas y, por cada longitud,
+ *        cuántas cadenas se aceptan, se rechazan o alcanzan el límite y sus pasos
+ * @param nombreFichero Fichero con la definición de la máquina
+ * @param opciones Opciones de la enumeración
+ * @return Código de salida
+ */
+int enumerarLenguaje(const string& nombreFichero, const OpcionesEnumeracion& opciones) {
+  Enumerador enumerador(Motor::desdeFichero(nombreFichero));
+  ResultadoEnumeracion resultado = enumerador.enumerar(opciones);
+
+  cout << "Cadenas aceptadas (" << resultado.aceptadas.size() << "):" << endl;
+  for (const string& cadena : resultado.aceptadas) {
+    cout << (cadena.empty() ? "." : cadena) << endl; // La cadena vacía se muestra como epsilon
+  }
+  cout << endl;
+  cout << "Longitud     Cadenas   Aceptadas  Rechazadas      Límite    Pasos mín   Pasos medios    Pasos máx" << endl;
+  auto mostrar = [](const string& longitud, const ResumenLongitud& resumen) {
+    cout << setw(8) << longitud << setw(12) << resumen.cadenas << setw(12) << resumen.aceptadas << setw(12) << resumen.rechazadas
+         << setw(12) << resumen.limitePasos << setw(13) << resumen.pasosMinimos << setw(15) << fixed << setprecision(1)
+         << resumen.pasosMedios() << setw(13) << resumen.pasosMaximos << endl;
+  };
+  for (size_t longitud = 0; longitud < resultado.porLongitud.size(); ++longitud) {
+    if (resultado.porLongitud[longitud].cadenas > 0) {
+      mostrar(to_string(longitud), resultado.porLongitud[longitud]);
+    }
+  }
+  mostrar("Total", resultado.total);
+  return 0;
+}
+
 /**
  * @brief Función principal del programa
  * @param argc Número de argumentos
  * @param argv Vector de argumentos
  * @return Código de salida
  */
-
 int main(int argc, char* argv[]) {
+  if (argc >= 3 && string(argv[1]) == "--tuberia") {
+    try {
+      return ejecutarTuberia(vector<string>(argv + 2, argv + argc));
+    } catch (const exception& e) {
+      cerr << "Error: " << e.what() << endl;
+      return 1;
+    }
+  }
+  if (argc >= 4 && string(argv[2]) == "--entrada") {
+    try {
+      // Opciones adicionales: --limite <pasos> y --registro <configuraciones>
+      Opciones opciones;
+      opciones.volcadoRegistro = &cerr;
+      if ((argc - 4) % 2 != 0) {
+        throw ErrorArgumentos("Falta el valor de la opción " + string(argv[argc - 1]));
+      }
+      for (int i = 4; i < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "--limite") {
+          opciones.limitePasos = leerNumero<long>(opcion, argv[i + 1]);
+        } else if (opcion == "--registro") {
+          opciones.registroVuelo = leerNumero<size_t>(opcion, argv[i + 1]);
+        } else {
+          throw ErrorArgumentos("Opción desconocida: " + opcion);
+        }
+      }
+      return ejecutarFichero(argv[1], argv[3], opciones);
+    } catch (const ErrorArgumentos& e) {
+      cerr << "Error: " << e.what() << endl;
+      mostrarUso(argv[0]);
+      return 1;
+    } catch (const exception& e) {
+      cerr << "Error: " << e.what() << endl;
+      return 1;
+    }
+  }
+  if (argc >= 4 && string(argv[2]) == "--enumerar") {
+    try {
+      // Opciones adicionales: --muestra <cadenas>, --semilla <semilla>, --limite <pasos> y --hilos <hilos>
+      OpcionesEnumeracion opciones;
+      opciones.longitudMaxima = leerNumero<size_t>("--enumerar", argv[3]);
+      if ((argc - 4) % 2 != 0) {
+        throw ErrorArgumentos("Falta el valor de la opción " + string(argv[argc - 1]));
+      }
+      for (int i = 4; i < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "--muestra") {
+          opciones.muestra = leerNumero<size_t>(opcion, argv[i + 1]);
+        } else if (opcion == "--semilla") {
+          opciones.semilla = leerNumero<uint64_t>(opcion, argv[i + 1]);
+        } else if (opcion == "--limite") {
+          opciones.limitePasos = leerNumero<long>(opcion, argv[i + 1]);
+          if (opciones.limitePasos == 0) {
+            throw ErrorArgumentos("Valor no válido para " + opcion + ": la enumeración necesita un límite de pasos");
+          }
+        } else if (opcion == "--hilos") {
+          opciones.hilos = leerNumero<size_t>(opcion, argv[i + 1], max(1u, thread::hardware_concurrency())); // Como mucho uno por núcleo
+        } else {
+          throw ErrorArgumentos("Opción desconocida: " + opcion);
+        }
+      }
+      return enumerarLenguaje(argv[1], opciones);
+    } catch (const ErrorArgumentos& e) {
+      cerr << "Error: " << e.what() << endl;
+      mostrarUso(argv[0]);
+      return 1;
+    } catch (const exception& e) {
+      cerr << "Error: " << e.what() << endl;
+      return 1;
+    }
+  }
   if (argc != 2) {
-    cerr << "Uso: " << argv[0] << " <fichero_entrada>" << endl;
+    mostrarUso(argv[0]);
     return 1;
   }
 
@@ -43,6 +246,7 @@ int main(int argc, char* argv[]) {
       mt.reiniciar();
     }
 
+    liberarEstados(datos);
     return 0;
   } catch (const exception& e) {
     cerr << "Error: " << e.what() << endl;
@@ -15,7 +15,7 @@ MaquinaTuring::MaquinaTuring(const vector<Estado*>& estados, const Alfabeto& alf
   cintas_.resize(numCintas, Cinta(alfabetoCinta));
   if (numCintas > 1) {
     for (int i = 1; i < numCintas; ++i) {
-      cintas_[i].insertar("."); // Relleno las cintas adicionales con un blanco
+      cintas_[i].insertar({'.'}); // Relleno las cintas adicionales con un blanco
     }
   }
 
@@ -35,17 +35,18 @@ MaquinaTuring::MaquinaTuring(const vector<Estado*>& estados, const Alfabeto& alf
  */
 bool MaquinaTuring::ejecutar(string cadena) {
   // Compruebo si la cadena es válida
-  if (!esValida(cadena)) {
+  vector<Simbolo> simbolos;
+  if (!codificar(cadena, simbolos)) {
     cerr << "Error: La cadena contiene símbolos que no pertenecen al alfabeto de entrada." << endl;
     return false;
   }
 
   // Inserto la cadena en la cinta 1
-  cintas_[0].insertar(cadena);
+  cintas_[0].insertar(simbolos);
 
   while (true) {
     // Leo los simbolos de las cintas
-    vector<char> simbolosLeidos;
+    vector<Simbolo> simbolosLeidos;
     for (Cinta& cinta : cintas_) {
       simbolosLeidos.push_back(cinta.leer());
     }
@@ -54,18 +55,25 @@ bool MaquinaTuring::ejecutar(string cadena) {
     Transicion* transicion = obtenerTransicionPosible(simbolosLeidos);
 
     // Muestro la traza
-    mostrarTraza(cadena, transicion);
+    if (traza_) mostrarTraza(transicion);
 
     if (transicion == nullptr) {
       // No hay transicion posible
       return false;
     }
 
+    // Compruebo el límite de pasos antes de aplicar la transición
+    if (limitePasos_ > 0 && pasos_ >= limitePasos_) {
+      limiteAlcanzado_ = true;
+      return false;
+    }
+
     // Ejecuto la transicion
     estadoActual_ = transicion->ejecutar(cintas_);
+    pasos_++;
 
     if (estadoActual_->esAceptacion()) {
-      mostrarTraza(cadena, nullptr);
+      if (traza_) mostrarTraza(nullptr);
       return true;
     }
   }
@@ -76,7 +84,7 @@ bool MaquinaTuring::ejecutar(string cadena) {
  * @param simbolosLeidos Símbolos leídos en las cintas
  * @return Transición posible o nullptr si no hay ninguna
  */
-Transicion* MaquinaTuring::obtenerTransicionPosible(vector<char> simbolosLeidos) {
+Transicion* MaquinaTuring::obtenerTransicionPosible(vector<Simbolo> simbolosLeidos) {
   Transicion* transicionPosible = nullptr;
 
   for (auto& transicion : estadoActual_->getTransiciones()) {
@@ -90,11 +98,10 @@ Transicion* MaquinaTuring::obtenerTransicionPosible(vector<char> simbolosLeidos)
 
 /**
  * @brief Método para mostrar la traza de la ejecución del autómata
- * @param cadena Cadena de entrada
  * @param transicion Transición actual
  * @return void
  */
-void MaquinaTuring::mostrarTraza(const string& cadena, const Transicion* transicion) {
+void MaquinaTuring::mostrarTraza(const Transicion* transicion) {
   cout << "-------------------------------------------------" << endl;
   cout << "Estado actual: " << estadoActual_->getId() << endl;
   for (size_t i = 0; i < cintas_.size(); ++i) {
@@ -121,6 +128,8 @@ void MaquinaTuring::reiniciar() {
   for (Cinta& cinta : cintas_) {
     cinta.limpiar();
   }
+  pasos_ = 0;
+  limiteAlcanzado_ = false;
 }
 
 /**
@@ -129,7 +138,21 @@ void MaquinaTuring::reiniciar() {
  * @return true si la cadena es válida, false en caso contrario
  */
 bool MaquinaTuring::esValida(const string& cadena) const {
-  for (char simbolo : cadena) {
+  vector<Simbolo> simbolos;
+  return codificar(cadena, simbolos);
+}
+
+/**
+ * @brief Método para obtener los códigos de los símbolos de una cadena, comprobando que es válida
+ * @param cadena Cadena de entrada (con los símbolos separados por espacios si alguno tiene varios caracteres)
+ * @param simbolos Códigos de los símbolos de la cadena
+ * @return true si la cadena es válida, false en caso contrario
+ */
+bool MaquinaTuring::codificar(const string& cadena, vector<Simbolo>& simbolos) const {
+  if (!alfabetoEntrada_.getTabla().codificar(cadena, simbolos)) {
+    return false;
+  }
+  for (Simbolo simbolo : simbolos) {
     if (!alfabetoEntrada_.pertenece(simbolo) && simbolo != '.') {
       return false;
     }
@@ -25,14 +25,27 @@ class MaquinaTuring {
     bool ejecutar(string cadena);
     bool esValida(const string& cadena) const;
     void reiniciar();
-    void mostrarTraza(const string& cadena, const Transicion* transicion);
-    Transicion* obtenerTransicionPosible(vector<char> simbolosLeidos);
+    void mostrarTraza(const Transicion* transicion);
+    Transicion* obtenerTransicionPosible(vector<Simbolo> simbolosLeidos);
+
+    // Getters y setters de la ejecución
+    inline void setTraza(bool traza) { traza_ = traza; }
+    inline void setLimitePasos(long limitePasos) { limitePasos_ = limitePasos; } // 0 = sin límite
+    inline long getPasos() const { return pasos_; }
+    inline bool limiteAlcanzado() const { return limiteAlcanzado_; }
+    inline const vector<Cinta>& getCintas() const { return cintas_; }
 
   private:
+    bool codificar(const string& cadena, vector<Simbolo>& simbolos) const; // Codifica y valida la cadena
+
     vector<Estado*> estados_;
     Alfabeto alfabetoEntrada_;
     vector<Cinta> cintas_;
     Estado* estadoActual_;
+    bool traza_ = true;
+    long limitePasos_ = 0;
+    long pasos_ = 0;
+    bool limiteAlcanzado_ = false;
 };
 
 #endif // MAQUINATURING_H
\ No newline at end of file
@@ -0,0 +1,491 @@
+#include "motor.h"
+#include "../programa/programa.h"
+#include <cstring> // Para memcmp
+#include <ostream>
+#include <mutex> // Para serializar la carga
+#include <sstream> // Para istringstream
+#include <stdexcept> // Para las excepciones
+
+static mutex cargaMutex; // leerFlujo trabaja sobre un estado global en tools.cc
+
+/**
+ * @brief Tabla con los núcleos especializados de una anchura de símbolo, indexada por número de cintas - 1
+ */
+template <typename S, size_t... I>
+constexpr array<Motor::Nucleo, sizeof...(I)> Motor::tablaNucleos(index_sequence<I...>) {
+  return {&Motor::ejecutarEspecializado<I + 1, S>...};
+}
+
+/**
+ * @brief Método para elegir el núcleo de ejecución de una anchura de símbolo
+ * @param numCintas Número de cintas de la máquina
+ * @return Núcleo especializado si lo hay, el genérico en caso contrario
+ */
+template <typename S>
+Motor::Nucleo Motor::elegirNucleo(size_t numCintas) {
+  static constexpr auto especializados = tablaNucleos<S>(make_index_sequence<MAX_CINTAS_ESPECIALIZADAS>());
+  return numCintas <= especializados.size() ? especializados[numCintas - 1] : &Motor::ejecutarGenerico<S>;
+}
+
+/**
+ * @brief Constructor de la clase Motor, elige el núcleo de ejecución de la máquina
+ * @param programa Máquina cargada
+ */
+Motor::Motor(shared_ptr<const Programa> programa) : programa_(std::move(programa)) {
+  size_t numCintas = static_cast<size_t>(programa_->numCintas());
+  nucleo_ = programa_->anchura() == 1 ? elegirNucleo<char>(numCintas) : elegirNucleo<uint16_t>(numCintas);
+}
+
+/**
+ * @brief Carga una máquina desde un fichero con el formato de /data
+ * @param nombreFichero Nombre del fichero
+ * @return Motor con la máquina cargada
+ */
+Motor Motor::desdeFichero(const string& nombreFichero) {
+  lock_guard<mutex> lock(cargaMutex);
+  return Motor(make_shared<const Programa>(Programa::desdeFichero(nombreFichero)));
+}
+
+/**
+ * @brief Carga una máquina desde un buffer en memoria con el formato de /data
+ * @param definicion Texto de la definición
+ * @return Motor con la máquina cargada
+ */
+Motor Motor::desdeMemoria(string_view definicion) {
+  istringstream flujo{string(definicion)};
+  lock_guard<mutex> lock(cargaMutex);
+  return Motor(make_shared<const Programa>(Programa::desdeFlujo(flujo)));
+}
+
+/**
+ * @brief Método para obtener la memoria ocupada por la máquina cargada
+ * @return Bytes ocupados
+ */
+size_t Motor::memoria() const {
+  return programa_->memoria();
+}
+
+/**
+ * @brief Método para obtener la tabla de símbolos de la máquina
+ * @return Tabla de símbolos
+ */
+const TablaSimbolos& Motor::tablaSimbolos() const {
+  return programa_->tablaSimbolos();
+}
+
+/**
+ * @brief Método para obtener los símbolos con los que se pueden escribir las entradas
+ * @return Códigos de los símbolos de Σ (sin el blanco), de menor a mayor
+ */
+vector<Simbolo> Motor::alfabetoEntrada() const {
+  vector<Simbolo> alfabeto;
+  const vector<uint8_t>& validos = programa_->entradaValida();
+  for (size_t c = 0; c < programa_->tablaSimbolos().numCodigos(); ++c) {
+    if (validos[c] && c != '.') {
+      alfabeto.push_back(static_cast<Simbolo>(c));
+    }
+  }
+  return alfabeto;
+}
+
+/**
+ * @brief Método para obtener el número de cintas de la última ejecución
+ * @return Número de cintas (0 si todavía no se ha ejecutado nada)
+ */
+size_t Contexto::numCintas() const {
+  if (simbolos_ == nullptr) {
+    return 0;
+  }
+  return simbolos_->anchura() == 1 ? estrechas_.cintas.size() : anchas_.cintas.size();
+}
+
+/**
+ * @brief Método para obtener el contenido de una cinta sin los blancos de los extremos
+ * @param i Cinta (empezando en 0)
+ * @return Contenido de la cinta
+ */
+string Contexto::contenidoCinta(size_t i) const {
+  return simbolos_->anchura() == 1 ? estrechas_.cintas[i].contenido(*simbolos_) : anchas_.cintas[i].contenido(*simbolos_);
+}
+
+/**
+ * @brief Método para volcar una cinta con el cabezal marcado entre corchetes
+ * @param i Cinta (empezando en 0)
+ * @return Texto de la cinta
+ */
+string Contexto::volcarCinta(size_t i) const {
+  return simbolos_->anchura() == 1 ? estrechas_.cintas[i].volcar(*simbolos_) : anchas_.cintas[i].volcar(*simbolos_);
+}
+
+/**
+ * @brief Método para volcar el registro de vuelo de la última ejecución con el formato de la
+ *        traza de MaquinaTuring, de la configuración más antigua a la más reciente
+ * @param contexto Contexto de la ejecución
+ * @param os Flujo de salida
+ * @return void
+ */
+void Motor::volcarRegistro(const Contexto& contexto, ostream& os) const {
+  const RegistroVuelo& registro = contexto.registro_;
+  os << "---- Registro de vuelo: últimas " << registro.size() << " configuraciones ----" << endl;
+  for (size_t i = 0; i < registro.size(); ++i) {
+    const ConfiguracionRegistrada& configuracion = registro.configuracion(i);
+    os << "-------------------------------------------------" << endl;
+    os << "Paso: " << configuracion.paso << endl;
+    os << "Estado actual: " << programa_->nombre(configuracion.estado) << endl;
+    for (int cinta = 0; cinta < programa_->numCintas(); ++cinta) {
+      const Simbolo* ventana = registro.ventana(i, cinta);
+      string texto;
+      for (size_t j = 0; j < registro.anchoVentana(); ++j) {
+        programa_->tablaSimbolos().anadir(texto, ventana[j], j == static_cast<size_t>(registro.getRadio())); // Indicar la posicion del cabezal
+      }
+      os << "Cinta " << cinta + 1 << ": " << texto << endl;
+    }
+    os << "transición: " << (configuracion.transicion >= 0 ? to_string(configuracion.transicion) : "-") << endl;
+  }
+  os << "-------------------------------------------------" << endl;
+}
+
+/**
+ * @brief Método para obtener el número de cintas de la máquina
+ * @return Número de cintas
+ */
+int Motor::numCintas() const {
+  return programa_->numCintas();
+}
+
+/**
+ * @brief Método para ejecutar la máquina sobre una entrada sin escribir nada por consola
+ * @param entrada Cadena de entrada, se carga directamente en la cinta 1
+ * @param contexto Memoria de trabajo de la ejecución
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la ejecución
+ */
+Resultado Motor::ejecutar(string_view entrada, Contexto& contexto, const Opciones& opciones) const {
+  comprobarOpciones(opciones);
+  contexto.proyeccion_.liberar();
+  return programa_->anchura() == 1 ? ejecutarCadena<char>(entrada, contexto, opciones) : ejecutarCadena<uint16_t>(entrada, contexto, opciones);
+}
+
+/**
+ * @brief Método para cargar una cadena en la cinta 1 y ejecutar la máquina. Con la codificación
+ *        directa los bytes de la cadena son los códigos; si no, la cadena se codifica símbolo a
+ *        símbolo en el Contexto antes de cargarla.
+ * @param entrada Cadena de entrada
+ * @param contexto Memoria de trabajo de la ejecución
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la ejecución
+ */
+template <typename S>
+Resultado Motor::ejecutarCadena(string_view entrada, Contexto& contexto, const Opciones& opciones) const {
+  vector<CintaSegmentada<S>>& cintas = prepararCintas<S>(contexto);
+  const TablaSimbolos& simbolos = programa_->tablaSimbolos();
+  bool valida;
+  if (simbolos.directa()) {
+    valida = cintas[0].cargar(entrada, programa_->entradaValida());
+  } else {
+    bool conocidos = simbolos.codificar(entrada, contexto.codigos_);
+    valida = cintas[0].cargarCodigos(contexto.codigos_.data(), contexto.codigos_.size(), programa_->entradaValida()) && conocidos;
+  }
+  if (!valida) {
+    return Resultado{Veredicto::EntradaInvalida};
+  }
+  return ejecutarCargada<S>(contexto, opciones);
+}
+
+/**
+ * @brief Método para ejecutar la máquina usando un fichero proyectado en memoria como contenido
+ *        inicial de la cinta 1. Solo se copian las páginas del fichero en las que escribe la
+ *        máquina y la validación es la única lectura completa del fichero. Se ignora el salto de
+ *        línea final del fichero, si lo tiene. Si algún símbolo tiene varios caracteres, el
+ *        fichero se codifica en la cinta como cualquier otra cadena.
+ * @param nombreFichero Fichero con la cadena de entrada
+ * @param contexto Memoria de trabajo de la ejecución, mantiene la proyección hasta la siguiente ejecución
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la ejecución
+ */
+Resultado Motor::ejecutarFichero(const string& nombreFichero, Contexto& contexto, const Opciones& opciones) const {
+  comprobarOpciones(opciones);
+  contexto.proyeccion_ = FicheroProyectado(nombreFichero);
+  const FicheroProyectado& proyeccion = contexto.proyeccion_;
+  size_t tam = proyeccion.size();
+  while (tam > 0 && (proyeccion.datos()[tam - 1] == '\n' || proyeccion.datos()[tam - 1] == '\r')) {
+    tam--;
+  }
+
+  if (!programa_->tablaSimbolos().directa()) {
+    string_view entrada(proyeccion.datos(), tam);
+    return programa_->anchura() == 1 ? ejecutarCadena<char>(entrada, contexto, opciones) : ejecutarCadena<uint16_t>(entrada, contexto, opciones);
+  }
+
+  vector<CintaSegmentada<char>>& cintas = prepararCintas<char>(contexto);
+  proyeccion.accesoSecuencial();
+  bool valida = cintas[0].cargarExterna(proyeccion.datos(), tam, programa_->entradaValida());
+  proyeccion.accesoNormal();
+  if (!valida) {
+    return Resultado{Veredicto::EntradaInvalida};
+  }
+  return ejecutarCargada<char>(contexto, opciones);
+}
+
+/**
+ * @brief Método para ejecutar la máquina usando como cinta 1 una cinta ya escrita (normalmente la
+ *        salida de otra máquina, obtenida con Contexto::tomarCinta). La cinta se traspasa al
+ *        contexto sin copiar sus celdas y la entrada es su contenido sin los blancos de los extremos.
+ * @param entrada Cinta de entrada con los códigos de esta máquina; al volver contiene una cinta sin
+ *        uso que se puede reutilizar
+ * @param contexto Memoria de trabajo de la ejecución
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la ejecución
+ */
+template <typename S>
+Resultado Motor::ejecutarCinta(CintaSegmentada<S>& entrada, Contexto& contexto, const Opciones& opciones) const {
+  if (sizeof(S) != programa_->anchura()) {
+    throw invalid_argument("La cinta no tiene la anchura de los símbolos de la máquina.");
+  }
+  comprobarOpciones(opciones);
+  vector<CintaSegmentada<S>>& cintas = prepararCintas<S>(contexto);
+  swap(cintas[0], entrada);
+  if (!cintas[0].prepararEntrada(programa_->entradaValida())) {
+    return Resultado{Veredicto::EntradaInvalida};
+  }
+  return ejecutarCargada<S>(contexto, opciones);
+}
+
+template Resultado Motor::ejecutarCinta(CintaSegmentada<char>& entrada, Contexto& contexto, const Opciones& opciones) const;
+template Resultado Motor::ejecutarCinta(CintaSegmentada<uint16_t>& entrada, Contexto& contexto, const Opciones& opciones) const;
+
+/**
+ * @brief Método para comprobar las opciones antes de ejecutar, de forma que un error no espere
+ *        al final de la ejecución
+ * @param opciones Opciones de la ejecución (lanza out_of_range si cintasSalida pide una cinta que
+ *        la máquina no tiene)
+ */
+void Motor::comprobarOpciones(const Opciones& opciones) const {
+  for (size_t cinta : opciones.cintasSalida) {
+    if (cinta >= static_cast<size_t>(programa_->numCintas())) {
+      throw out_of_range("La máquina no tiene la cinta " + to_string(cinta + 1) + ".");
+    }
+  }
+}
+
+/**
+ * @brief Método para dimensionar las cintas del contexto y dejar en blanco las cintas 2..n
+ * @param contexto Memoria de trabajo de la ejecución
+ * @return Cintas de la anchura de la máquina
+ */
+template <typename S>
+vector<CintaSegmentada<S>>& Motor::prepararCintas(Contexto& contexto) const {
+  CintasContexto<S>& memoria = contexto.cintasDe<S>();
+  contexto.simbolos_ = &programa_->tablaSimbolos();
+  memoria.cintas.resize(programa_->numCintas());
+  memoria.leidos.resize(programa_->numCintas());
+  for (size_t i = 1; i < memoria.cintas.size(); ++i) {
+    memoria.cintas[i].cargar("", programa_->entradaValida());
+  }
+  return memoria.cintas;
+}
+
+/**
+ * @brief Método para ejecutar la máquina una vez cargada la entrada en la cinta 1: aplica el
+ *        núcleo elegido al cargar la máquina y prepara las salidas pedidas
+ * @param contexto Memoria de trabajo de la ejecución
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la ejecución
+ */
+template <typename S>
+Resultado Motor::ejecutarCargada(Contexto& contexto, const Opciones& opciones) const {
+  vector<CintaSegmentada<S>>& cintas = contexto.cintasDe<S>().cintas;
+  const size_t numCintas = cintas.size();
+  contexto.registro_.preparar(opciones.registroVuelo, numCintas, opciones.radioRegistro);
+
+  Nucleo nucleo = opciones.nucleoGenerico ? &Motor::ejecutarGenerico<S> : nucleo_;
+  Resultado resultado = nucleo(*programa_, contexto, opciones);
+
+  // Las ventanas del registro de vuelo solo se reconstruyen (y se vuelcan) si la ejecución no acepta
+  bool fallida = resultado.veredicto == Veredicto::Rechazada || resultado.veredicto == Veredicto::LimitePasos || resultado.veredicto == Veredicto::Cancelada;
+  if (fallida && contexto.registro_.activo()) {
+    contexto.registro_.reconstruirVentanas(cintas);
+    if (opciones.volcadoRegistro != nullptr) {
+      volcarRegistro(contexto, *opciones.volcadoRegistro);
+    }
+  }
+
+  for (const CintaSegmentada<S>& cinta : cintas) {
+    resultado.celdasUsadas += cinta.celdasUsadas();
+  }
+  // Copio las cintas pedidas (la 1 en salidas_[0] si se conserva, el resto a continuación)
+  size_t numSalidas = opciones.cintasSalida.size() + 1;
+  if (contexto.salidas_.size() < numSalidas) {
+    contexto.salidas_.resize(numSalidas);
+  }
+  if (opciones.conservarCinta) {
+    cintas[0].copiarContenido(contexto.salidas_[0], programa_->tablaSimbolos());
+    resultado.cinta = contexto.salidas_[0];
+  }
+  for (size_t i = 0; i < opciones.cintasSalida.size(); ++i) {
+    size_t cinta = opciones.cintasSalida[i]; // Comprobada en comprobarOpciones
+    cintas[cinta].copiarContenido(contexto.salidas_[i + 1], programa_->tablaSimbolos());
+    resultado.salidas.push_back(contexto.salidas_[i + 1]);
+  }
+  return resultado;
+}
+
+/**
+ * @brief Núcleo de ejecución especializado para N cintas con símbolos de tipo S. Los símbolos
+ *        leídos, los cabezales y los límites de cada cinta se guardan en arrays locales de tamaño
+ *        fijo, de forma que el compilador puede desenrollar los bucles sobre las cintas y
+ *        mantenerlos en registros.
+ * @param programa Máquina cargada
+ * @param contexto Memoria de trabajo con la entrada ya cargada
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la ejecución (sin celdas usadas ni salidas)
+ */
+template <size_t N, typename S>
+Resultado Motor::ejecutarEspecializado(const Programa& programa, Contexto& contexto, const Opciones& opciones) {
+  array<CintaSegmentada<S>*, N> cintas;
+  array<long, N> cabezales, primeras, ultimas;
+  for (size_t i = 0; i < N; ++i) {
+    cintas[i] = &contexto.cintasDe<S>().cintas[i];
+    cabezales[i] = cintas[i]->getCabezal();
+    primeras[i] = cintas[i]->primeraCelda();
+    ultimas[i] = cintas[i]->ultimaCelda();
+  }
+
+  Resultado resultado;
+  const long limitePasos = opciones.limitePasos;
+  const atomic<bool>* cancelar = opciones.cancelar;
+  RegistroVuelo* registroVuelo = contexto.registro_.activo() ? &contexto.registro_ : nullptr;
+  long pasos = 0;
+  uint32_t estado = programa.inicial();
+  while (true) {
+    // Leo los simbolos de las cintas
+    array<S, N> leidos;
+    for (size_t i = 0; i < N; ++i) {
+      leidos[i] = cintas[i]->celda(cabezales[i]);
+    }
+
+    // Busco la primera transición aplicable
+    const RegistroEstado& registro = programa.estado(estado);
+    uint32_t transicion = registro.primeraTransicion;
+    const uint32_t fin = registro.primeraTransicion + registro.numTransiciones;
+    while (transicion < fin && memcmp(programa.lectura<S>(transicion), leidos.data(), N * sizeof(S)) != 0) {
+      transicion++;
+    }
+    if (registroVuelo != nullptr) {
+      Huella* huellas = registroVuelo->anotar(pasos, estado, transicion == fin ? -1 : programa.transicion(transicion).id);
+      for (size_t i = 0; i < N; ++i) {
+        huellas[i] = Huella{cabezales[i], codigoDe(leidos[i])};
+      }
+    }
+    if (transicion == fin) {
+      resultado.veredicto = Veredicto::Rechazada;
+      break;
+    }
+    if (limitePasos > 0 && pasos >= limitePasos) {
+      resultado.veredicto = Veredicto::LimitePasos;
+      break;
+    }
+    if (cancelar != nullptr && (pasos & 4095) == 0 && cancelar->load(memory_order_relaxed)) {
+      resultado.veredicto = Veredicto::Cancelada;
+      break;
+    }
+
+    // Escribo en las cintas y muevo los cabezales
+    const S* escritura = programa.escritura<S>(transicion);
+    const char* movimientos = programa.movimientos(transicion);
+    for (size_t i = 0; i < N; ++i) {
+      cintas[i]->celda(cabezales[i]) = escritura[i];
+      if (movimientos[i] == 'R') {
+        if (++cabezales[i] > ultimas[i]) {
+          cintas[i]->crecerDerecha();
+          ultimas[i]++;
+        }
+      } else if (movimientos[i] == 'L') {
+        if (--cabezales[i] < primeras[i]) {
+          cintas[i]->crecerIzquierda();
+          primeras[i]--;
+        }
+      }
+    }
+    pasos++;
+    estado = programa.transicion(transicion).siguiente;
+
+    if (programa.estado(estado).aceptacion) {
+      resultado.veredicto = Veredicto::Aceptada;
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    cintas[i]->setCabezal(cabezales[i]);
+  }
+  resultado.pasos = pasos;
+  return resultado;
+}
+
+/**
+ * @brief Núcleo de ejecución para cualquier número de cintas con símbolos de tipo S, usado cuando
+ *        no hay uno especializado
+ * @param programa Máquina cargada
+ * @param contexto Memoria de trabajo con la entrada ya cargada
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la ejecución (sin celdas usadas ni salidas)
+ */
+template <typename S>
+Resultado Motor::ejecutarGenerico(const Programa& programa, Contexto& contexto, const Opciones& opciones) {
+  vector<CintaSegmentada<S>>& cintas = contexto.cintasDe<S>().cintas;
+  vector<S>& leidos = contexto.cintasDe<S>().leidos;
+  RegistroVuelo* registroVuelo = contexto.registro_.activo() ? &contexto.registro_ : nullptr;
+  Resultado resultado;
+
+  const size_t numCintas = cintas.size();
+  uint32_t estado = programa.inicial();
+  while (true) {
+    // Leo los simbolos de las cintas
+    for (size_t i = 0; i < numCintas; ++i) {
+      leidos[i] = cintas[i].leer();
+    }
+
+    // Busco la primera transición aplicable, como MaquinaTuring::obtenerTransicionPosible
+    const RegistroEstado& registro = programa.estado(estado);
+    uint32_t transicion = registro.primeraTransicion;
+    const uint32_t fin = registro.primeraTransicion + registro.numTransiciones;
+    while (transicion < fin && memcmp(programa.lectura<S>(transicion), leidos.data(), numCintas * sizeof(S)) != 0) {
+      transicion++;
+    }
+    if (registroVuelo != nullptr) {
+      Huella* huellas = registroVuelo->anotar(resultado.pasos, estado, transicion == fin ? -1 : programa.transicion(transicion).id);
+      for (size_t i = 0; i < numCintas; ++i) {
+        huellas[i] = Huella{cintas[i].getCabezal(), codigoDe(leidos[i])};
+      }
+    }
+    if (transicion == fin) {
+      resultado.veredicto = Veredicto::Rechazada;
+      break;
+    }
+    if (opciones.limitePasos > 0 && resultado.pasos >= opciones.limitePasos) {
+      resultado.veredicto = Veredicto::LimitePasos;
+      break;
+    }
+    if (opciones.cancelar != nullptr && (resultado.pasos & 4095) == 0 && opciones.cancelar->load(memory_order_relaxed)) {
+      resultado.veredicto = Veredicto::Cancelada;
+      break;
+    }
+
+    // Escribo en las cintas y muevo los cabezales
+    const S* escritura = programa.escritura<S>(transicion);
+    const char* movimientos = programa.movimientos(transicion);
+    for (size_t i = 0; i < numCintas; ++i) {
+      cintas[i].escribir(escritura[i]);
+      cintas[i].mover(movimientos[i]);
+    }
+    resultado.pasos++;
+    estado = programa.transicion(transicion).siguiente;
+
+    if (programa.estado(estado).aceptacion) {
+      resultado.veredicto = Veredicto::Aceptada;
+      break;
+    }
+  }
+  return resultado;
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "../cintaSegmentada/cintaSegmentada.h"
+#include "../ficheroProyectado/ficheroProyectado.h"
+#include "../registroVuelo/registroVuelo.h"
+#include <array>
+#include <atomic> // Para la cancelación
+#include <iosfwd> // Para ostream
+#include <memory> // Para shared_ptr
+#include <string>
+#include <string_view>
+#include <utility> // Para index_sequence
+#include <vector>
+
+#ifndef MOTOR_H
+#define MOTOR_H
+
+using namespace std;
+
+/**
+ * @enum Veredicto
+ * @brief Forma en la que termina una ejecución
+ */
+enum class Veredicto { Aceptada, Rechazada, LimitePasos, EntradaInvalida, Cancelada };
+
+/**
+ * @struct Opciones
+ * @brief Opciones de una ejecución
+ */
+struct Opciones {
+  long limitePasos = 0;        // 0 = sin límite
+  bool conservarCinta = false; // Rellenar Resultado::cinta con el contenido final de la cinta 1
+  vector<size_t> cintasSalida; // Modo transductor: cintas (empezando en 0) que se devuelven en Resultado::salidas
+  bool nucleoGenerico = false; // Usar el bucle genérico aunque haya un núcleo especializado (pruebas y medidas)
+  size_t registroVuelo = 0;    // Últimas configuraciones que se guardan en el registro de vuelo (0 = desactivado)
+  int radioRegistro = 4;       // Celdas a cada lado del cabezal que se muestran de cada cinta (>= 0)
+  ostream* volcadoRegistro = nullptr;   // Si se indica, el registro se vuelca aquí cuando la ejecución no acepta
+  const atomic<bool>* cancelar = nullptr; // Si se indica y pasa a true, la ejecución termina como Cancelada
+};
+
+/**
+ * @struct Resultado
+ * @brief Resultado de una ejecución
+ */
+struct Resultado {
+  Veredicto veredicto = Veredicto::Rechazada;
+  long pasos = 0;          // Transiciones aplicadas
+  size_t celdasUsadas = 0; // Celdas ocupadas entre todas las cintas
+  string_view cinta;       // Cinta 1 sin blancos en los extremos, válida hasta la siguiente ejecución con el mismo Contexto
+  vector<string_view> salidas; // Contenido de Opciones::cintasSalida, con la misma validez que cinta
+};
+
+/**
+ * @struct CintasContexto
+ * @brief Cintas de trabajo de una anchura de símbolo (S es char o uint16_t)
+ */
+template <typename S>
+struct CintasContexto {
+  vector<CintaSegmentada<S>> cintas;
+  vector<S> leidos;
+};
+
+/**
+ * @class Contexto
+ * @brief Memoria de trabajo de una ejecución. Se reutiliza entre ejecuciones para no reservar
+ *        memoria en cada una y no debe compartirse entre hilos. Mientras se consulte, el Motor
+ *        de la última ejecución debe seguir existiendo.
+ */
+class Contexto {
+  public:
+    // Constructor y destructor
+    Contexto() = default;
+    Contexto(Contexto&&) = default;
+    Contexto& operator=(Contexto&&) = default;
+    ~Contexto() = default;
+
+    // Getters
+    size_t numCintas() const;
+    string contenidoCinta(size_t i) const;
+    string volcarCinta(size_t i) const;
+    inline const RegistroVuelo& registroVuelo() const { return registro_; } // Registro de la última ejecución (ventanas solo si no acepta)
+
+    // Métodos
+    template <typename S> inline void tomarCinta(size_t i, CintaSegmentada<S>& destino) { swap(cintasDe<S>().cintas.at(i), destino); } // Traspasa la cinta i sin copiarla
+
+  private:
+    friend class Motor;
+    template <typename S> inline CintasContexto<S>& cintasDe() {
+      if constexpr (sizeof(S) == 1) return estrechas_; else return anchas_;
+    }
+    template <typename S> inline const CintasContexto<S>& cintasDe() const {
+      if constexpr (sizeof(S) == 1) return estrechas_; else return anchas_;
+    }
+
+    CintasContexto<char> estrechas_;  // Máquinas con símbolos de 8 bits
+    CintasContexto<uint16_t> anchas_; // Máquinas con símbolos de 16 bits
+    const TablaSimbolos* simbolos_ = nullptr; // Símbolos de la máquina de la última ejecución
+    vector<Simbolo> codigos_;         // Entrada codificada cuando los símbolos tienen varios caracteres
+    vector<string> salidas_;
+    RegistroVuelo registro_;
+    FicheroProyectado proyeccion_; // Entrada de ejecutarFichero, se mantiene hasta la siguiente ejecución
+};
+
+class Programa; // Representación interna de la máquina cargada (src/programa/programa.h)
+
+/**
+ * @class Motor
+ * @brief Máquina de Turing cargada para ser embebida en otros programas. El motor es inmutable
+ *        una vez cargado: un mismo Motor (o sus copias, que comparten la máquina) puede atender
+ *        ejecuciones concurrentes siempre que cada hilo use su propio Contexto. La carga también
+ *        puede hacerse desde varios hilos, aunque se realiza de una en una. Si algún símbolo tiene
+ *        varios caracteres, las entradas y salidas llevan los símbolos separados por espacios.
+ */
+class Motor {
+  public:
+    // Carga de la máquina (lanza runtime_error si la definición no es válida)
+    static Motor desdeFichero(const string& nombreFichero);
+    static Motor desdeMemoria(string_view definicion);
+
+    // Métodos
+    Resultado ejecutar(string_view entrada, Contexto& contexto, const Opciones& opciones = {}) const;
+    Resultado ejecutarFichero(const string& nombreFichero, Contexto& contexto, const Opciones& opciones = {}) const;
+    template <typename S> Resultado ejecutarCinta(CintaSegmentada<S>& entrada, Contexto& contexto, const Opciones& opciones = {}) const;
+    void volcarRegistro(const Contexto& contexto, ostream& os) const;
+    int numCintas() const;
+    const TablaSimbolos& tablaSimbolos() const; // Códigos de los símbolos; su anchura es la de las cintas
+    vector<Simbolo> alfabetoEntrada() const;    // Códigos de Σ sin el blanco, de menor a mayor
+    size_t memoria() const; // Bytes ocupados por la máquina cargada
+
+  private:
+    friend class MotorCarriles; // Construye su tabla densa a partir del Programa
+    friend class MotorBloques;  // Copia las transiciones de las máquinas de una cinta
+    using Nucleo = Resultado (*)(const Programa& programa, Contexto& contexto, const Opciones& opciones);
+
+    explicit Motor(shared_ptr<const Programa> programa);
+    void comprobarOpciones(const Opciones& opciones) const;
+    template <typename S> vector<CintaSegmentada<S>>& prepararCintas(Contexto& contexto) const;
+    template <typename S> Resultado ejecutarCadena(string_view entrada, Contexto& contexto, const Opciones& opciones) const;
+    template <typename S> Resultado ejecutarCargada(Contexto& contexto, const Opciones& opciones) const;
+
+    // Núcleos de ejecución: uno especializado por cada número de cintas hasta MAX_CINTAS_ESPECIALIZADAS
+    // y anchura de símbolo
+    static constexpr size_t MAX_CINTAS_ESPECIALIZADAS = 8;
+    template <size_t N, typename S> static Resultado ejecutarEspecializado(const Programa& programa, Contexto& contexto, const Opciones& opciones);
+    template <typename S> static Resultado ejecutarGenerico(const Programa& programa, Contexto& contexto, const Opciones& opciones);
+    template <typename S, size_t... I> static constexpr array<Nucleo, sizeof...(I)> tablaNucleos(index_sequence<I...>);
+    template <typename S> static Nucleo elegirNucleo(size_t numCintas);
+
+    shared_ptr<const Programa> programa_;
+    Nucleo nucleo_; // Elegido al cargar la máquina según su número de cintas y la anchura de sus símbolos
+};
+
+#endif // MOTOR_H
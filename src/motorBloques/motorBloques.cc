@@ -0,0 +1,574 @@
+#include "motorBloques.h"
+#include "../programa/programa.h"
+#include <bit> // Para bit_ceil
+#include <cstring> // Para memcpy
+#include <limits>
+#include <stdexcept> // Para las excepciones
+
+/**
+ * @brief Función hash del contenido de una hoja
+ */
+size_t MemoriaBloques::HashHoja::operator()(const Hoja& hoja) const {
+  uint64_t partes[sizeof(Hoja) / sizeof(uint64_t)];
+  memcpy(partes, hoja.data(), sizeof(Hoja));
+  uint64_t hash = 0;
+  for (uint64_t parte : partes) {
+    hash = (hash ^ parte) * 0x9E3779B97F4A7C15ull;
+  }
+  return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Método para dejar la memoria lista para ejecutar una máquina. Los bloques y la caché se
+ *        conservan si son de la misma máquina y no se ha llegado al máximo de nodos, pero el límite
+ *        pasa a ser maxNodos aunque compactar() lo hubiera subido (la ejecución anterior pudo usar
+ *        otro máximo); si la cinta ocupa casi todo, el siguiente avance compacta y lo vuelve a subir.
+ * @param programa Máquina que se va a ejecutar
+ * @param tamCache Entradas de la caché (potencia de 2)
+ * @param maxNodos Nodos a partir de los que se compacta el árbol
+ * @return void
+ */
+void MemoriaBloques::preparar(const shared_ptr<const Programa>& programa, size_t tamCache, size_t maxNodos) {
+  if (programa_ == programa && cache_.size() == tamCache && nodos_.size() <= maxNodos) {
+    limiteNodos_ = maxNodos;
+    return;
+  }
+  programa_ = programa;
+  nodos_.clear();
+  hojas_.clear();
+  idHojas_.clear();
+  idInternos_.clear();
+  blancos_.clear();
+  cache_.assign(tamCache, EntradaCache{});
+  limiteNodos_ = maxNodos;
+  aciertos_ = 0;
+  pico_ = 0;
+}
+
+/**
+ * @brief Método para comprobar que cabe un nodo más antes de crearlo
+ * @return void
+ */
+void MemoriaBloques::reservarNodo() {
+  if (nodos_.size() >= MAX_NODOS) {
+    throw runtime_error("La cinta ha superado el número máximo de bloques.");
+  }
+  pico_ = max(pico_, nodos_.size() + 1);
+}
+
+/**
+ * @brief Método para obtener el nodo de una hoja, creándolo si no existe
+ * @param celdas Contenido de la hoja
+ * @return Nodo de la hoja
+ */
+uint32_t MemoriaBloques::hoja(const Hoja& celdas) {
+  auto it = idHojas_.find(celdas);
+  if (it != idHojas_.end()) {
+    return it->second;
+  }
+  reservarNodo();
+  uint32_t nodo = static_cast<uint32_t>(nodos_.size());
+  nodos_.push_back(Nodo{static_cast<uint32_t>(hojas_.size()), HOJA});
+  hojas_.push_back(celdas);
+  idHojas_.emplace(celdas, nodo);
+  return nodo;
+}
+
+/**
+ * @brief Método para obtener el nodo formado por dos nodos del mismo nivel, creándolo si no existe
+ * @param izquierdo Mitad izquierda
+ * @param derecho Mitad derecha
+ * @return Nodo del nivel siguiente
+ */
+uint32_t MemoriaBloques::interno(uint32_t izquierdo, uint32_t derecho) {
+  uint64_t clave = (static_cast<uint64_t>(izquierdo) << 32) | derecho;
+  auto it = idInternos_.find(clave);
+  if (it != idInternos_.end()) {
+    return it->second;
+  }
+  reservarNodo();
+  uint32_t nodo = static_cast<uint32_t>(nodos_.size());
+  nodos_.push_back(Nodo{izquierdo, derecho});
+  idInternos_.emplace(clave, nodo);
+  return nodo;
+}
+
+/**
+ * @brief Método para obtener el nodo en blanco de un nivel
+ * @param nivel Nivel del nodo
+ * @return Nodo con todas sus celdas en blanco
+ */
+uint32_t MemoriaBloques::blanco(int nivel) {
+  while (static_cast<int>(blancos_.size()) <= nivel) {
+    if (blancos_.empty()) {
+      Hoja celdas;
+      celdas.fill('.');
+      blancos_.push_back(hoja(celdas));
+    } else {
+      blancos_.push_back(interno(blancos_.back(), blancos_.back()));
+    }
+  }
+  return blancos_[nivel];
+}
+
+/**
+ * @brief Método para ampliar la cinta con bloques en blanco hasta que contenga el cabezal. Cada
+ *        ampliación duplica el ancho de la cinta por el lado por el que ha salido el cabezal.
+ * @return void
+ */
+void MemoriaBloques::ampliar() {
+  while (cabezal_ < 0 || cabezal_ >= ancho(nivel_)) {
+    if (nivel_ >= MAX_NIVELES) {
+      throw runtime_error("La cinta ha superado el tamaño máximo.");
+    }
+    uint32_t vacio = blanco(nivel_);
+    if (cabezal_ < 0) {
+      raiz_ = interno(vacio, raiz_);
+      cabezal_ += ancho(nivel_);
+    } else {
+      raiz_ = interno(raiz_, vacio);
+    }
+    nivel_++;
+  }
+}
+
+/**
+ * @brief Método para quedarse solo con los nodos de la cinta actual cuando se supera el máximo de
+ *        nodos. Los avances de la caché hacen referencia a nodos eliminados, así que se vacía. Si
+ *        la cinta actual ocupa más de la mitad del máximo, el límite pasa a ser el doble de sus
+ *        nodos para no compactar en cada avance.
+ * @param maxNodos Nodos a partir de los que se compacta el árbol
+ * @return void
+ */
+void MemoriaBloques::compactar(size_t maxNodos) {
+  if (nodos_.size() <= limiteNodos_) {
+    return;
+  }
+  vector<Nodo> nodos = std::move(nodos_);
+  vector<Hoja> hojas = std::move(hojas_);
+  nodos_.clear();
+  hojas_.clear();
+  idHojas_.clear();
+  idInternos_.clear();
+  blancos_.clear();
+  unordered_map<uint32_t, uint32_t> copiados;
+  auto copiar = [&](auto& self, uint32_t nodo) -> uint32_t {
+    auto it = copiados.find(nodo);
+    if (it != copiados.end()) {
+      return it->second;
+    }
+    const Nodo original = nodos[nodo];
+    uint32_t copia = original.derecho == HOJA ? hoja(hojas[original.izquierdo]) : interno(self(self, original.izquierdo), self(self, original.derecho));
+    copiados.emplace(nodo, copia);
+    return copia;
+  };
+  raiz_ = copiar(copiar, raiz_);
+  blanco(nivel_);
+  cache_.assign(cache_.size(), EntradaCache{});
+  limiteNodos_ = max(maxNodos, 2 * nodos_.size()); // Si la cinta ocupa casi todo el máximo, no compacto en cada avance
+}
+
+/**
+ * @brief Método para obtener la primera celda que no es blanco de un nodo
+ * @param nodo Nodo
+ * @param nivel Nivel del nodo
+ * @return Posición de la celda respecto al inicio del nodo, -1 si está en blanco
+ */
+long MemoriaBloques::primeraNoBlanca(uint32_t nodo, int nivel) const {
+  if (nivel < static_cast<int>(blancos_.size()) && nodo == blancos_[nivel]) {
+    return -1;
+  }
+  const Nodo& actual = nodos_[nodo];
+  if (nivel == 0) {
+    const Hoja& celdas = hojas_[actual.izquierdo];
+    for (size_t i = 0; i < TAM_HOJA; ++i) {
+      if (celdas[i] != '.') return static_cast<long>(i);
+    }
+    return -1;
+  }
+  long posicion = primeraNoBlanca(actual.izquierdo, nivel - 1);
+  if (posicion >= 0) {
+    return posicion;
+  }
+  posicion = primeraNoBlanca(actual.derecho, nivel - 1);
+  return posicion >= 0 ? posicion + ancho(nivel - 1) : -1;
+}
+
+/**
+ * @brief Método para obtener la última celda que no es blanco de un nodo
+ * @param nodo Nodo
+ * @param nivel Nivel del nodo
+ * @return Posición de la celda respecto al inicio del nodo, -1 si está en blanco
+ */
+long MemoriaBloques::ultimaNoBlanca(uint32_t nodo, int nivel) const {
+  if (nivel < static_cast<int>(blancos_.size()) && nodo == blancos_[nivel]) {
+    return -1;
+  }
+  const Nodo& actual = nodos_[nodo];
+  if (nivel == 0) {
+    const Hoja& celdas = hojas_[actual.izquierdo];
+    for (size_t i = TAM_HOJA; i-- > 0;) {
+      if (celdas[i] != '.') return static_cast<long>(i);
+    }
+    return -1;
+  }
+  long posicion = ultimaNoBlanca(actual.derecho, nivel - 1);
+  if (posicion >= 0) {
+    return posicion + ancho(nivel - 1);
+  }
+  return ultimaNoBlanca(actual.izquierdo, nivel - 1);
+}
+
+/**
+ * @brief Método para escribir como texto las celdas [desde, hasta] de la cinta que están en un nodo
+ * @param nodo Nodo
+ * @param nivel Nivel del nodo
+ * @param base Posición de la primera celda del nodo
+ * @param desde Primera celda que se escribe
+ * @param hasta Última celda que se escribe
+ * @param marcarCabezal Si es true el cabezal se marca entre corchetes
+ * @param destino Texto al que se añaden las celdas
+ * @return void
+ */
+void MemoriaBloques::copiar(uint32_t nodo, int nivel, long base, long desde, long hasta, bool marcarCabezal, string& destino) const {
+  if (base > hasta || base + ancho(nivel) <= desde) {
+    return;
+  }
+  const Nodo& actual = nodos_[nodo];
+  if (nivel > 0) {
+    copiar(actual.izquierdo, nivel - 1, base, desde, hasta, marcarCabezal, destino);
+    copiar(actual.derecho, nivel - 1, base + ancho(nivel - 1), desde, hasta, marcarCabezal, destino);
+    return;
+  }
+  const Hoja& celdas = hojas_[actual.izquierdo];
+  for (size_t i = 0; i < TAM_HOJA; ++i) {
+    long posicion = base + static_cast<long>(i);
+    if (posicion >= desde && posicion <= hasta) {
+      programa_->tablaSimbolos().anadir(destino, celdas[i], marcarCabezal && posicion == cabezal_);
+    }
+  }
+}
+
+/**
+ * @brief Método para obtener el número de cintas de la última ejecución
+ * @return Número de cintas (0 si todavía no se ha ejecutado nada)
+ */
+size_t MemoriaBloques::numCintas() const {
+  if (conMotor_) {
+    return contexto_.numCintas();
+  }
+  return programa_ != nullptr ? 1 : 0;
+}
+
+/**
+ * @brief Método para obtener el contenido de una cinta sin los blancos de los extremos
+ * @param i Cinta (empezando en 0)
+ * @return Contenido de la cinta
+ */
+string MemoriaBloques::contenidoCinta(size_t i) const {
+  if (conMotor_) {
+    return contexto_.contenidoCinta(i);
+  }
+  string texto;
+  long inicio = primeraNoBlanca(raiz_, nivel_);
+  if (inicio >= 0) {
+    copiar(raiz_, nivel_, 0, inicio, ultimaNoBlanca(raiz_, nivel_), false, texto);
+  }
+  return texto;
+}
+
+/**
+ * @brief Método para volcar una cinta con el cabezal marcado entre corchetes, con el mismo formato
+ *        que Contexto::volcarCinta
+ * @param i Cinta (empezando en 0)
+ * @return Texto de la cinta
+ */
+string MemoriaBloques::volcarCinta(size_t i) const {
+  if (conMotor_) {
+    return contexto_.volcarCinta(i);
+  }
+  long inicio = primeraNoBlanca(raiz_, nivel_), fin = ultimaNoBlanca(raiz_, nivel_);
+  long desde = inicio >= 0 ? min(inicio, cabezal_) : cabezal_;
+  long hasta = inicio >= 0 ? max(fin, cabezal_) : cabezal_;
+  string texto;
+  copiar(raiz_, nivel_, 0, desde, hasta, true, texto);
+  return texto;
+}
+
+/**
+ * @brief Constructor de la clase MotorBloques, copia las transiciones de la máquina si tiene una cinta
+ * @param motor Máquina cargada
+ * @param maxNodos Nodos del árbol a partir de los que se compacta (se eliminan los que no son de la
+ *        cinta actual y se vacía la caché)
+ * @param tamCache Entradas de la caché de avances (se redondea a una potencia de 2)
+ */
+MotorBloques::MotorBloques(Motor motor, size_t maxNodos, size_t tamCache)
+    : motor_(std::move(motor)), maxNodos_(maxNodos), tamCache_(bit_ceil(max<size_t>(tamCache, 1))) {
+  if (!enBloques()) {
+    return;
+  }
+  const Programa& programa = *motor_.programa_;
+  for (uint32_t estado = 0; estado < programa.numEstados(); ++estado) {
+    const RegistroEstado& registro = programa.estado(estado);
+    rangos_.emplace_back(registro.primeraTransicion, registro.primeraTransicion + registro.numTransiciones);
+    aceptacion_.push_back(registro.aceptacion);
+  }
+  for (uint32_t t = 0; t < programa.numTransiciones(); ++t) {
+    bool estrecha = programa.anchura() == 1;
+    Simbolo lectura = estrecha ? codigoDe(programa.lectura<char>(t)[0]) : programa.lectura<uint16_t>(t)[0];
+    Simbolo escritura = estrecha ? codigoDe(programa.escritura<char>(t)[0]) : programa.escritura<uint16_t>(t)[0];
+    char movimiento = programa.movimientos(t)[0];
+    int8_t desplazamiento = movimiento == 'R' ? 1 : (movimiento == 'L' ? -1 : 0);
+    transiciones_.push_back(TransicionBloque{lectura, escritura, desplazamiento, programa.transicion(t).siguiente});
+  }
+}
+
+/**
+ * @brief Método para ejecutar la máquina sobre una entrada sin escribir nada por consola
+ * @param entrada Cadena de entrada
+ * @param memoria Memoria de trabajo, con los bloques y avances de las ejecuciones anteriores
+ * @param opciones Opciones de la ejecución. La cancelación se consulta entre avances y cada 4096
+ *        pasos dentro de una hoja.
+ * @return Resultado de la ejecución. celdasUsadas es el ancho del árbol de la cinta, y cinta y
+ *         salidas son válidas hasta la siguiente ejecución con la misma memoria.
+ */
+Resultado MotorBloques::ejecutar(string_view entrada, MemoriaBloques& memoria, const Opciones& opciones) const {
+  if (!enBloques() || opciones.registroVuelo > 0 || opciones.nucleoGenerico) {
+    memoria.conMotor_ = true;
+    return motor_.ejecutar(entrada, memoria.contexto_, opciones);
+  }
+  for (size_t cinta : opciones.cintasSalida) {
+    if (cinta >= 1) {
+      throw out_of_range("La máquina no tiene la cinta " + to_string(cinta + 1) + ".");
+    }
+  }
+  const Programa& programa = *motor_.programa_;
+  memoria.conMotor_ = false;
+  memoria.preparar(motor_.programa_, tamCache_, maxNodos_);
+  memoria.cancelar_ = opciones.cancelar;
+
+  // Codifico la entrada y construyo el árbol de la cinta, hoja a hoja y nivel a nivel
+  bool valida = programa.tablaSimbolos().codificar(entrada, memoria.codigos_);
+  for (Simbolo codigo : memoria.codigos_) {
+    valida = valida && codigo < programa.entradaValida().size() && programa.entradaValida()[codigo];
+  }
+  vector<uint32_t> nodos;
+  for (size_t i = 0; valida && i < memoria.codigos_.size(); i += MemoriaBloques::TAM_HOJA) {
+    MemoriaBloques::Hoja celdas;
+    for (size_t j = 0; j < MemoriaBloques::TAM_HOJA; ++j) {
+      celdas[j] = i + j < memoria.codigos_.size() ? memoria.codigos_[i + j] : Simbolo{'.'};
+    }
+    nodos.push_back(memoria.hoja(celdas));
+  }
+  if (nodos.empty()) {
+    nodos.push_back(memoria.blanco(0));
+  }
+  memoria.nivel_ = 0;
+  while (nodos.size() > 1) {
+    if (nodos.size() % 2 == 1) {
+      nodos.push_back(memoria.blanco(memoria.nivel_));
+    }
+    for (size_t i = 0; i < nodos.size() / 2; ++i) {
+      nodos[i] = memoria.interno(nodos[2 * i], nodos[2 * i + 1]);
+    }
+    nodos.resize(nodos.size() / 2);
+    memoria.nivel_++;
+  }
+  memoria.raiz_ = nodos[0];
+  memoria.cabezal_ = 0;
+  if (!valida) {
+    memoria.blanco(memoria.nivel_);
+    return Resultado{Veredicto::EntradaInvalida};
+  }
+
+  // Avanzo desde la posición del cabezal; si sale de la cinta, la amplío y sigo en el bloque nuevo
+  Resultado resultado;
+  uint32_t estado = programa.inicial();
+  while (true) {
+    long presupuesto = opciones.limitePasos > 0 ? opciones.limitePasos - resultado.pasos : numeric_limits<long>::max();
+    Avance avance = avanzarDesde(memoria, memoria.raiz_, memoria.nivel_, estado, memoria.cabezal_, presupuesto);
+    memoria.raiz_ = avance.nodo;
+    memoria.cabezal_ = avance.posicion;
+    resultado.pasos += avance.pasos;
+    estado = avance.estado;
+    memoria.ampliar();
+    if (avance.parada == Parada::SalidaIzquierda || avance.parada == Parada::SalidaDerecha || avance.parada == Parada::MemoriaLlena) {
+      memoria.compactar(maxNodos_);
+      continue;
+    }
+    switch (avance.parada) {
+      case Parada::Aceptada: resultado.veredicto = Veredicto::Aceptada; break;
+      case Parada::LimitePasos: resultado.veredicto = Veredicto::LimitePasos; break;
+      case Parada::Cancelada: resultado.veredicto = Veredicto::Cancelada; break;
+      default: resultado.veredicto = Veredicto::Rechazada; break;
+    }
+    break;
+  }
+  memoria.blanco(memoria.nivel_); // Para reconocer los bloques en blanco al escribir la cinta
+
+  resultado.celdasUsadas = static_cast<size_t>(MemoriaBloques::ancho(memoria.nivel_));
+  size_t numSalidas = opciones.cintasSalida.size() + 1;
+  if (memoria.salidas_.size() < numSalidas) {
+    memoria.salidas_.resize(numSalidas);
+  }
+  if (opciones.conservarCinta) {
+    memoria.salidas_[0] = memoria.contenidoCinta(0);
+    resultado.cinta = memoria.salidas_[0];
+  }
+  for (size_t i = 0; i < opciones.cintasSalida.size(); ++i) {
+    memoria.salidas_[i + 1] = memoria.contenidoCinta(0);
+    resultado.salidas.push_back(memoria.salidas_[i + 1]);
+  }
+  return resultado;
+}
+
+/**
+ * @brief Método para avanzar con el cabezal en uno de los extremos de un bloque. El resultado se
+ *        busca en la caché y, si no está o se pasa del presupuesto, se calcula y se guarda.
+ * @param memoria Memoria de trabajo
+ * @param nodo Bloque
+ * @param nivel Nivel del bloque
+ * @param estado Estado al entrar
+ * @param derecha Si es true el cabezal está en la última celda del bloque; si no, en la primera
+ * @param presupuesto Pasos que se pueden dar antes de llegar al límite
+ * @return Avance hasta salir del bloque o terminar
+ */
+Avance MotorBloques::avanzar(MemoriaBloques& memoria, uint32_t nodo, int nivel, uint32_t estado, bool derecha, long presupuesto) const {
+  uint64_t clave = (static_cast<uint64_t>(nodo) << 32) | (static_cast<uint64_t>(estado) << 1) | derecha;
+  size_t hueco = ((clave * 0x9E3779B97F4A7C15ull) >> 32) & (memoria.cache_.size() - 1);
+  const MemoriaBloques::EntradaCache& entrada = memoria.cache_[hueco];
+  if (entrada.clave == clave && entrada.avance.pasos <= presupuesto) {
+    memoria.aciertos_++;
+    return entrada.avance;
+  }
+
+  Avance avance;
+  if (nivel == 0) {
+    avance = avanzarHoja(memoria, nodo, estado, derecha ? MemoriaBloques::TAM_HOJA - 1 : 0, presupuesto);
+  } else {
+    uint32_t hijo = derecha ? memoria.nodos_[nodo].derecho : memoria.nodos_[nodo].izquierdo;
+    avance = continuar(memoria, nodo, nivel, derecha, avanzar(memoria, hijo, nivel - 1, estado, derecha, presupuesto), presupuesto);
+  }
+  // Los avances cortados por el límite, la cancelación o el máximo de nodos dependen de la
+  // ejecución y no se guardan
+  if (avance.parada != Parada::LimitePasos && avance.parada != Parada::Cancelada && avance.parada != Parada::MemoriaLlena) {
+    memoria.cache_[hueco] = MemoriaBloques::EntradaCache{clave, avance};
+  }
+  return avance;
+}
+
+/**
+ * @brief Método para avanzar con el cabezal en cualquier celda de un bloque: se baja hasta el
+ *        bloque del nivel inferior que lo contiene y, al salir de él, se sigue con avances desde
+ *        los extremos de sus hermanos
+ * @param memoria Memoria de trabajo
+ * @param nodo Bloque
+ * @param nivel Nivel del bloque
+ * @param estado Estado al entrar
+ * @param posicion Cabezal respecto al inicio del bloque
+ * @param presupuesto Pasos que se pueden dar antes de llegar al límite
+ * @return Avance hasta salir del bloque o terminar
+ */
+Avance MotorBloques::avanzarDesde(MemoriaBloques& memoria, uint32_t nodo, int nivel, uint32_t estado, long posicion, long presupuesto) const {
+  if (posicion == 0 || posicion == MemoriaBloques::ancho(nivel) - 1) {
+    return avanzar(memoria, nodo, nivel, estado, posicion != 0, presupuesto);
+  }
+  if (nivel == 0) {
+    return avanzarHoja(memoria, nodo, estado, posicion, presupuesto);
+  }
+  const long mitad = MemoriaBloques::ancho(nivel - 1);
+  int hijo = posicion >= mitad ? 1 : 0;
+  uint32_t nodoHijo = hijo == 1 ? memoria.nodos_[nodo].derecho : memoria.nodos_[nodo].izquierdo;
+  return continuar(memoria, nodo, nivel, hijo, avanzarDesde(memoria, nodoHijo, nivel - 1, estado, posicion - hijo * mitad, presupuesto), presupuesto);
+}
+
+/**
+ * @brief Método para ejecutar paso a paso dentro de una hoja, con las mismas comprobaciones y en
+ *        el mismo orden que los núcleos del Motor
+ * @param memoria Memoria de trabajo
+ * @param nodo Hoja
+ * @param estado Estado al entrar
+ * @param posicion Cabezal respecto al inicio de la hoja
+ * @param presupuesto Pasos que se pueden dar antes de llegar al límite
+ * @return Avance hasta salir de la hoja o terminar
+ */
+Avance MotorBloques::avanzarHoja(MemoriaBloques& memoria, uint32_t nodo, uint32_t estado, long posicion, long presupuesto) const {
+  MemoriaBloques::Hoja celdas = memoria.hojas_[memoria.nodos_[nodo].izquierdo];
+  Avance avance{Parada::Rechazada, 0, estado, posicion, 0};
+  while (true) {
+    // Busco la primera transición aplicable
+    auto [transicion, fin] = rangos_[avance.estado];
+    while (transicion < fin && transiciones_[transicion].lectura != celdas[avance.posicion]) {
+      transicion++;
+    }
+    if (transicion == fin) {
+      avance.parada = Parada::Rechazada;
+      break;
+    }
+    if (avance.pasos >= presupuesto) {
+      avance.parada = Parada::LimitePasos;
+      break;
+    }
+    if (memoria.cancelar_ != nullptr && (avance.pasos & 4095) == 0 && memoria.cancelar_->load(memory_order_relaxed)) {
+      avance.parada = Parada::Cancelada;
+      break;
+    }
+
+    const TransicionBloque& aplicada = transiciones_[transicion];
+    celdas[avance.posicion] = aplicada.escritura;
+    avance.posicion += aplicada.desplazamiento;
+    avance.pasos++;
+    avance.estado = aplicada.siguiente;
+    if (aceptacion_[avance.estado]) {
+      avance.parada = Parada::Aceptada; // El cabezal puede haber salido de la hoja
+      break;
+    }
+    if (avance.posicion < 0 || avance.posicion >= static_cast<long>(MemoriaBloques::TAM_HOJA)) {
+      avance.parada = avance.posicion < 0 ? Parada::SalidaIzquierda : Parada::SalidaDerecha;
+      break;
+    }
+  }
+  avance.nodo = memoria.hoja(celdas);
+  return avance;
+}
+
+/**
+ * @brief Método para seguir avanzando dentro de un bloque después de que el cabezal haya salido de
+ *        una de sus mitades: mientras pase a la otra mitad se avanza desde su extremo. Si se ha
+ *        superado el máximo de nodos, se para antes de entrar en la otra mitad para que el árbol
+ *        se compacte sin que un avance largo lo haga crecer sin límite.
+ * @param memoria Memoria de trabajo
+ * @param nodo Bloque
+ * @param nivel Nivel del bloque
+ * @param hijo Mitad en la que se ha avanzado (0 izquierda, 1 derecha)
+ * @param avance Avance en esa mitad
+ * @param presupuesto Pasos que se podían dar antes de ese avance
+ * @return Avance hasta salir del bloque o terminar
+ */
+Avance MotorBloques::continuar(MemoriaBloques& memoria, uint32_t nodo, int nivel, int hijo, Avance avance, long presupuesto) const {
+  array<uint32_t, 2> hijos = {memoria.nodos_[nodo].izquierdo, memoria.nodos_[nodo].derecho};
+  const long mitad = MemoriaBloques::ancho(nivel - 1);
+  long pasos = 0;
+  while (true) {
+    hijos[hijo] = avance.nodo;
+    pasos += avance.pasos;
+    bool haciaHermano = (avance.parada == Parada::SalidaDerecha && hijo == 0) || (avance.parada == Parada::SalidaIzquierda && hijo == 1);
+    if (!haciaHermano) {
+      break;
+    }
+    hijo = 1 - hijo;
+    if (memoria.cancelar_ != nullptr && memoria.cancelar_->load(memory_order_relaxed)) {
+      avance = Avance{Parada::Cancelada, 0, avance.estado, hijo == 1 ? 0 : mitad - 1, 0}; // Cabezal en el extremo de la otra mitad
+      break;
+    }
+    if (memoria.nodos_.size() > memoria.limiteNodos_) {
+      avance = Avance{Parada::MemoriaLlena, 0, avance.estado, hijo == 1 ? 0 : mitad - 1, 0};
+      break;
+    }
+    avance = avanzar(memoria, hijos[hijo], nivel - 1, avance.estado, hijo == 0, presupuesto - pasos);
+  }
+  avance.nodo = memoria.interno(hijos[0], hijos[1]);
+  avance.posicion += hijo * mitad;
+  avance.pasos = pasos;
+  return avance;
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include "../motor/motor.h"
+#include <array>
+#include <atomic> // Para la cancelación
+#include <memory> // Para shared_ptr
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef MOTORBLOQUES_H
+#define MOTORBLOQUES_H
+
+using namespace std;
+
+class Programa; // Representación interna de la máquina cargada (src/programa/programa.h)
+
+/**
+ * @enum Parada
+ * @brief Forma en la que termina un avance dentro de un bloque de la cinta
+ */
+enum class Parada : uint8_t { SalidaIzquierda, SalidaDerecha, Aceptada, Rechazada, LimitePasos, Cancelada, MemoriaLlena };
+
+/**
+ * @struct Avance
+ * @brief Resultado de ejecutar la máquina dentro de un bloque hasta que el cabezal sale de él o
+ *        la ejecución termina
+ */
+struct Avance {
+  Parada parada = Parada::Rechazada;
+  uint32_t nodo = 0;   // Bloque con el contenido final
+  uint32_t estado = 0; // Estado al salir o al terminar
+  long posicion = 0;   // Cabezal respecto al inicio del bloque (-1 o el ancho del bloque si ha salido)
+  long pasos = 0;
+};
+
+/**
+ * @class MemoriaBloques
+ * @brief Memoria de trabajo de MotorBloques: la cinta como árbol de bloques compartidos y la caché
+ *        de avances. Se reutiliza entre ejecuciones de la misma máquina, que aprovechan los avances
+ *        ya calculados, y no debe compartirse entre hilos.
+ */
+class MemoriaBloques {
+  public:
+    static constexpr size_t TAM_HOJA = 8;   // Celdas de los bloques del nivel 0
+    static constexpr int MAX_NIVELES = 48;  // El bloque de la cinta completa tiene como mucho TAM_HOJA << MAX_NIVELES celdas
+    static constexpr size_t MAX_NODOS = UINT32_MAX - 1; // Los nodos se identifican con 32 bits (UINT32_MAX es HOJA)
+
+    // Constructor y destructor
+    MemoriaBloques() = default;
+    MemoriaBloques(MemoriaBloques&&) = default;
+    MemoriaBloques& operator=(MemoriaBloques&&) = default;
+    ~MemoriaBloques() = default;
+
+    // Getters
+    size_t numCintas() const;
+    string contenidoCinta(size_t i) const;
+    string volcarCinta(size_t i) const;
+    inline size_t numNodos() const { return nodos_.size(); }
+    inline long aciertos() const { return aciertos_; } // Avances leídos de la caché desde que se preparó la memoria
+    inline size_t picoNodos() const { return pico_; }  // Máximo de nodos desde que se preparó la memoria
+
+    // Ancho de los bloques de cada nivel
+    static inline long ancho(int nivel) { return static_cast<long>(TAM_HOJA) << nivel; }
+
+  private:
+    friend class MotorBloques;
+    using Hoja = array<Simbolo, TAM_HOJA>;
+
+    /**
+     * @struct Nodo
+     * @brief Bloque de la cinta: dos bloques del nivel anterior o, en el nivel 0, una hoja
+     */
+    struct Nodo {
+      uint32_t izquierdo; // En las hojas, índice de sus celdas
+      uint32_t derecho;   // En las hojas, HOJA
+    };
+    static constexpr uint32_t HOJA = UINT32_MAX;
+
+    struct EntradaCache {
+      uint64_t clave = VACIA; // Nodo, estado y lado por el que entra el cabezal
+      Avance avance;
+    };
+    static constexpr uint64_t VACIA = UINT64_MAX;
+
+    struct HashHoja {
+      size_t operator()(const Hoja& hoja) const;
+    };
+
+    void preparar(const shared_ptr<const Programa>& programa, size_t tamCache, size_t maxNodos);
+    void reservarNodo();
+    uint32_t hoja(const Hoja& celdas);
+    uint32_t interno(uint32_t izquierdo, uint32_t derecho);
+    uint32_t blanco(int nivel);
+    void ampliar();
+    void compactar(size_t maxNodos);
+    long primeraNoBlanca(uint32_t nodo, int nivel) const;
+    long ultimaNoBlanca(uint32_t nodo, int nivel) const;
+    void copiar(uint32_t nodo, int nivel, long base, long desde, long hasta, bool marcarCabezal, string& destino) const;
+
+    Contexto contexto_;     // Ejecuciones que se hacen con el Motor
+    bool conMotor_ = false; // Si la última ejecución se hizo con el Motor
+    shared_ptr<const Programa> programa_; // Máquina a la que corresponden los bloques y la caché
+    const atomic<bool>* cancelar_ = nullptr;
+    vector<Nodo> nodos_;
+    vector<Hoja> hojas_;
+    unordered_map<Hoja, uint32_t, HashHoja> idHojas_; // Cada contenido tiene un único nodo
+    unordered_map<uint64_t, uint32_t> idInternos_;
+    vector<uint32_t> blancos_;  // Nodo en blanco de cada nivel
+    vector<EntradaCache> cache_; // Con correspondencia directa: una entrada nueva sustituye a la que ocupa su hueco
+    size_t limiteNodos_ = 0;     // Nodos a partir de los que se interrumpe el avance y se compacta el árbol
+    long aciertos_ = 0;
+    size_t pico_ = 0;
+    uint32_t raiz_ = 0; // Cinta completa
+    int nivel_ = 0;
+    long cabezal_ = 0;  // Respecto al inicio de la raíz
+    vector<Simbolo> codigos_;
+    vector<string> salidas_;
+};
+
+/**
+ * @class MotorBloques
+ * @brief Motor para máquinas de una cinta que avanza bloques completos de la cinta. La cinta es un
+ *        árbol en el que cada bloque de un nivel son dos del anterior y los bloques iguales son el
+ *        mismo nodo. Para cada (bloque, estado, lado por el que entra el cabezal) se guarda en una
+ *        caché acotada el resultado de ejecutar hasta que el cabezal sale del bloque (bloque final,
+ *        estado, lado de salida y pasos), y los avances de un nivel se componen con los del nivel
+ *        anterior. En cómputos regulares un solo avance cubre muchos pasos. Los resultados son
+ *        exactamente los del Motor: cuando un avance guardado se pasaría del límite de pasos, se
+ *        baja de nivel hasta llegar al paso exacto. Si durante un avance el árbol pasa de maxNodos
+ *        nodos, el avance se interrumpe, se compacta el árbol y se sigue desde donde se quedó. Las
+ *        máquinas de varias cintas y las ejecuciones con registro de vuelo o núcleo genérico se
+ *        hacen con el Motor.
+ */
+class MotorBloques {
+  public:
+    // Constructor y destructor
+    explicit MotorBloques(Motor motor, size_t maxNodos = size_t{1} << 22, size_t tamCache = size_t{1} << 16);
+    ~MotorBloques() = default;
+
+    // Métodos
+    Resultado ejecutar(string_view entrada, MemoriaBloques& memoria, const Opciones& opciones = {}) const;
+
+    // Getters
+    inline bool enBloques() const { return motor_.numCintas() == 1; } // false si se ejecuta con el Motor
+    inline const Motor& motor() const { return motor_; }
+
+  private:
+    /**
+     * @struct TransicionBloque
+     * @brief Transición de una máquina de una cinta
+     */
+    struct TransicionBloque {
+      Simbolo lectura;
+      Simbolo escritura;
+      int8_t desplazamiento; // -1, 0 o 1
+      uint32_t siguiente;
+    };
+
+    Avance avanzar(MemoriaBloques& memoria, uint32_t nodo, int nivel, uint32_t estado, bool derecha, long presupuesto) const;
+    Avance avanzarDesde(MemoriaBloques& memoria, uint32_t nodo, int nivel, uint32_t estado, long posicion, long presupuesto) const;
+    Avance avanzarHoja(MemoriaBloques& memoria, uint32_t nodo, uint32_t estado, long posicion, long presupuesto) const;
+    Avance continuar(MemoriaBloques& memoria, uint32_t nodo, int nivel, int hijo, Avance avance, long presupuesto) const;
+
+    Motor motor_;
+    vector<TransicionBloque> transiciones_;
+    vector<pair<uint32_t, uint32_t>> rangos_; // Transiciones [primera, fin) de cada estado
+    vector<uint8_t> aceptacion_;
+    size_t maxNodos_;
+    size_t tamCache_;
+};
+
+#endif // MOTORBLOQUES_H
@@ -0,0 +1,463 @@
+#include "motorCarriles.h"
+#include "../programa/programa.h"
+#include <array>
+#include <bit> // Para countr_zero
+#include <limits> // Para numeric_limits
+#include <stdexcept> // Para las excepciones
+
+/**
+ * @struct TablaCarriles
+ * @brief Máquina compilada para los carriles. Los símbolos se renumeran en columnas (el blanco, los
+ *        de la entrada y los que leen o escriben las transiciones) y la transición aplicable se
+ *        guarda para cada estado y combinación de columnas leídas, respetando que se aplica la
+ *        primera del fichero.
+ */
+struct TablaCarriles {
+  size_t numCintas = 1;
+  size_t numColumnas = 0;
+  uint32_t inicial = 0;
+  uint8_t blanco = 0;               // Columna del blanco
+  vector<int32_t> transiciones;     // [estado][columna cinta 1]...[columna cinta n] -> transición (-1 si no hay)
+  uint32_t inactiva = 0;            // Transición válida que usan los carriles que no dan el paso (su efecto se descarta)
+  vector<uint32_t> destinos;        // Estado siguiente de cada transición, con el bit 31 a 1 si es de aceptación
+  vector<uint16_t> acciones;        // Por transición y cinta: columna que escribe y, en el byte alto, movimiento + 1
+  vector<int16_t> columnaEntrada;   // Columna de cada código admitido en la entrada (-1 si no se admite)
+  vector<Simbolo> codigos;          // Código de cada columna
+
+  bool codificar(const TablaSimbolos& simbolos, string_view entrada, vector<Simbolo>& auxiliar, vector<uint8_t>& columnas) const;
+  string texto(const TablaSimbolos& simbolos, const vector<uint8_t>& celdas, long cabezal, bool marcarCabezal) const;
+};
+
+/**
+ * @brief Método para pasar una entrada a columnas, validando sus símbolos
+ * @param simbolos Tabla de símbolos de la máquina
+ * @param entrada Cadena de entrada
+ * @param auxiliar Memoria para los códigos cuando los símbolos tienen varios caracteres
+ * @param columnas Columnas a las que se añade la entrada (normalmente la cinta 1 de un carril)
+ * @return true si todos los símbolos se admiten en la entrada, false en caso contrario
+ */
+bool TablaCarriles::codificar(const TablaSimbolos& simbolos, string_view entrada, vector<Simbolo>& auxiliar, vector<uint8_t>& columnas) const {
+  if (simbolos.directa()) {
+    for (char simbolo : entrada) {
+      int16_t columna = columnaEntrada[codigoDe(simbolo)];
+      if (columna < 0) {
+        return false;
+      }
+      columnas.push_back(static_cast<uint8_t>(columna));
+    }
+    return true;
+  }
+  if (!simbolos.codificar(entrada, auxiliar)) {
+    return false;
+  }
+  for (Simbolo codigo : auxiliar) {
+    if (codigo >= columnaEntrada.size() || columnaEntrada[codigo] < 0) {
+      return false;
+    }
+    columnas.push_back(static_cast<uint8_t>(columnaEntrada[codigo]));
+  }
+  return true;
+}
+
+/**
+ * @brief Método para escribir una cinta de un carril como texto
+ * @param simbolos Tabla de símbolos de la máquina
+ * @param celdas Columnas de la cinta
+ * @param cabezal Posición del cabezal
+ * @param marcarCabezal Si es true se conservan los blancos hasta el cabezal y se marca entre
+ *        corchetes (como CintaSegmentada::volcar); si no, se quitan los blancos de los extremos
+ *        (como CintaSegmentada::contenido)
+ * @return Texto de la cinta
+ */
+string TablaCarriles::texto(const TablaSimbolos& simbolos, const vector<uint8_t>& celdas, long cabezal, bool marcarCabezal) const {
+  long inicio = 0, fin = static_cast<long>(celdas.size()) - 1;
+  long hasta = marcarCabezal ? cabezal : fin + 1;
+  while (inicio < hasta && celdas[inicio] == blanco) inicio++;
+  hasta = marcarCabezal ? cabezal : inicio - 1;
+  while (fin > hasta && celdas[fin] == blanco) fin--;
+  string resultado;
+  for (long i = inicio; i <= fin; ++i) {
+    simbolos.anadir(resultado, codigos[celdas[i]], marcarCabezal && i == cabezal);
+  }
+  return resultado;
+}
+
+/**
+ * @brief Construye la tabla densa de una máquina con símbolos de tipo S
+ * @param programa Máquina cargada
+ * @return Tabla, o nullptr si hay más de 256 columnas o más de MAX_ENTRADAS_TABLA entradas
+ */
+template <typename S>
+static shared_ptr<const TablaCarriles> construirTabla(const Programa& programa) {
+  auto tabla = make_shared<TablaCarriles>();
+  const size_t numCintas = static_cast<size_t>(programa.numCintas());
+  const vector<uint8_t>& entradaValida = programa.entradaValida();
+  tabla->numCintas = numCintas;
+  tabla->inicial = programa.inicial();
+
+  // Columnas: primero el blanco, después los símbolos de la entrada y los de las transiciones
+  vector<int> columnaDe(entradaValida.size(), -1);
+  auto anadirColumna = [&](Simbolo codigo) {
+    if (columnaDe[codigo] < 0) {
+      columnaDe[codigo] = static_cast<int>(tabla->codigos.size());
+      tabla->codigos.push_back(codigo);
+    }
+  };
+  anadirColumna('.');
+  for (size_t codigo = 0; codigo < entradaValida.size(); ++codigo) {
+    if (entradaValida[codigo]) {
+      anadirColumna(static_cast<Simbolo>(codigo));
+    }
+  }
+  for (uint32_t t = 0; t < programa.numTransiciones(); ++t) {
+    for (size_t i = 0; i < 2 * numCintas; ++i) {
+      anadirColumna(codigoDe(programa.lectura<S>(t)[i])); // Lectura y escritura son consecutivas
+    }
+  }
+  tabla->numColumnas = tabla->codigos.size();
+  if (tabla->numColumnas > 256) {
+    return nullptr;
+  }
+  size_t numEntradas = programa.numEstados();
+  for (size_t i = 0; i < numCintas; ++i) {
+    numEntradas *= tabla->numColumnas;
+    if (numEntradas > MotorCarriles::MAX_ENTRADAS_TABLA) {
+      return nullptr;
+    }
+  }
+
+  tabla->blanco = static_cast<uint8_t>(columnaDe['.']);
+  tabla->columnaEntrada.assign(entradaValida.size(), -1);
+  for (size_t codigo = 0; codigo < entradaValida.size(); ++codigo) {
+    if (entradaValida[codigo]) {
+      tabla->columnaEntrada[codigo] = static_cast<int16_t>(columnaDe[codigo]);
+    }
+  }
+
+  // Transición aplicable de cada estado y combinación de columnas: la primera en el orden del fichero
+  tabla->transiciones.assign(numEntradas, -1);
+  for (uint32_t estado = 0; estado < programa.numEstados(); ++estado) {
+    const RegistroEstado& registro = programa.estado(estado);
+    for (uint32_t t = registro.primeraTransicion; t < registro.primeraTransicion + registro.numTransiciones; ++t) {
+      size_t indice = estado;
+      for (size_t i = 0; i < numCintas; ++i) {
+        indice = indice * tabla->numColumnas + columnaDe[codigoDe(programa.lectura<S>(t)[i])];
+      }
+      if (tabla->transiciones[indice] < 0) {
+        tabla->transiciones[indice] = static_cast<int32_t>(t);
+      }
+    }
+  }
+  // Cada transición en pocas lecturas: el estado siguiente con su aceptación y, por cinta, la
+  // escritura con el movimiento
+  for (uint32_t t = 0; t < programa.numTransiciones(); ++t) {
+    uint32_t siguiente = programa.transicion(t).siguiente;
+    tabla->destinos.push_back(siguiente | (static_cast<uint32_t>(programa.estado(siguiente).aceptacion) << 31));
+    for (size_t i = 0; i < numCintas; ++i) {
+      char movimiento = programa.movimientos(t)[i];
+      uint16_t desplazamiento = movimiento == 'R' ? 2 : (movimiento == 'L' ? 0 : 1);
+      tabla->acciones.push_back(static_cast<uint16_t>(columnaDe[codigoDe(programa.escritura<S>(t)[i])] | (desplazamiento << 8)));
+    }
+  }
+  // Transición de los carriles que no dan el paso, para que todos lean la tabla sin comprobar
+  // cuáles están activos; lo que escribe y el estado al que va se descartan
+  tabla->inactiva = programa.numTransiciones();
+  tabla->destinos.push_back(tabla->inicial);
+  tabla->acciones.insert(tabla->acciones.end(), numCintas, static_cast<uint16_t>(tabla->blanco | (1 << 8)));
+  return tabla;
+}
+
+/**
+ * @brief Constructor de la clase MotorCarriles, construye la tabla densa si la máquina cabe en ella
+ * @param motor Máquina cargada
+ * @param numCarriles Entradas que se ejecutan a la vez (8, 16 o 32)
+ */
+MotorCarriles::MotorCarriles(Motor motor, size_t numCarriles) : motor_(std::move(motor)), numCarriles_(numCarriles) {
+  if (numCarriles != 8 && numCarriles != 16 && numCarriles != 32) {
+    throw invalid_argument("El número de carriles debe ser 8, 16 o 32.");
+  }
+  const Programa& programa = *motor_.programa_;
+  tabla_ = programa.anchura() == 1 ? construirTabla<char>(programa) : construirTabla<uint16_t>(programa);
+  if (tabla_ != nullptr) {
+    size_t numCintas = tabla_->numCintas;
+    nucleo_ = numCarriles == 8 ? elegirNucleo<8>(numCintas) : (numCarriles == 16 ? elegirNucleo<16>(numCintas) : elegirNucleo<32>(numCintas));
+  }
+}
+
+/**
+ * @brief Tabla con los núcleos especializados de L carriles, indexada por número de cintas - 1
+ */
+template <size_t L, size_t... I>
+constexpr array<MotorCarriles::Nucleo, sizeof...(I)> MotorCarriles::tablaNucleos(index_sequence<I...>) {
+  return {&MotorCarriles::ejecutarCarriles<L, I + 1>...};
+}
+
+/**
+ * @brief Método para elegir el núcleo de L carriles
+ * @param numCintas Número de cintas de la máquina
+ * @return Núcleo especializado si lo hay, el que recorre las cintas en tiempo de ejecución en caso contrario
+ */
+template <size_t L>
+MotorCarriles::Nucleo MotorCarriles::elegirNucleo(size_t numCintas) {
+  static constexpr auto especializados = tablaNucleos<L>(make_index_sequence<MAX_CINTAS_ESPECIALIZADAS>());
+  return numCintas <= especializados.size() ? especializados[numCintas - 1] : &MotorCarriles::ejecutarCarriles<L, 0>;
+}
+
+/**
+ * @brief Método para ejecutar un lote de entradas sin escribir nada por consola. Se admiten las
+ *        mismas opciones que en Motor::ejecutar; con el registro de vuelo o el núcleo genérico las
+ *        entradas se ejecutan una a una con el Motor.
+ * @param entradas Cadenas de entrada
+ * @param opciones Opciones de cada ejecución (el límite de pasos es por entrada)
+ * @param volcarCintas Si es true se rellena ResultadoLote::cintas (salvo con entradas inválidas)
+ * @return Resultado de cada entrada, en el orden del lote
+ */
+vector<ResultadoLote> MotorCarriles::ejecutarLote(const vector<string>& entradas, const Opciones& opciones, bool volcarCintas) const {
+  for (size_t cinta : opciones.cintasSalida) {
+    if (cinta >= static_cast<size_t>(motor_.numCintas())) {
+      throw out_of_range("La máquina no tiene la cinta " + to_string(cinta + 1) + ".");
+    }
+  }
+  vector<ResultadoLote> resultados(entradas.size());
+  if (tabla_ == nullptr || opciones.registroVuelo > 0 || opciones.nucleoGenerico) {
+    ejecutarConMotor(entradas, opciones, volcarCintas, resultados);
+  } else {
+    (this->*nucleo_)(entradas, opciones, volcarCintas, resultados);
+  }
+  return resultados;
+}
+
+/**
+ * @brief Método para ejecutar el lote entrada a entrada con el Motor
+ * @param entradas Cadenas de entrada
+ * @param opciones Opciones de cada ejecución
+ * @param volcarCintas Si es true se rellena ResultadoLote::cintas
+ * @param resultados Resultado de cada entrada
+ * @return void
+ */
+void MotorCarriles::ejecutarConMotor(const vector<string>& entradas, const Opciones& opciones, bool volcarCintas, vector<ResultadoLote>& resultados) const {
+  Contexto contexto;
+  for (size_t e = 0; e < entradas.size(); ++e) {
+    Resultado ejecucion = motor_.ejecutar(entradas[e], contexto, opciones);
+    ResultadoLote& resultado = resultados[e];
+    resultado.veredicto = ejecucion.veredicto;
+    resultado.pasos = ejecucion.pasos;
+    resultado.cinta = ejecucion.cinta;
+    for (string_view salida : ejecucion.salidas) {
+      resultado.salidas.emplace_back(salida);
+    }
+    if (volcarCintas && resultado.veredicto != Veredicto::EntradaInvalida) {
+      for (size_t i = 0; i < contexto.numCintas(); ++i) {
+        resultado.cintas.push_back(contexto.volcarCinta(i));
+      }
+    }
+  }
+}
+
+/**
+ * @struct Carriles
+ * @brief Estado de L carriles, con un array por campo. La cinta i del carril l está en la
+ *        posición i * L + l de los arrays de cintas.
+ */
+template <size_t L>
+struct Carriles {
+  static constexpr size_t MARGEN = 16; // Blancos a cada lado de la entrada al cargar un carril
+
+  array<uint32_t, L> estados{};
+  array<int32_t, L> transiciones{};
+  array<long, L> pasos{};
+  array<size_t, L> entradas{}; // Índice en el lote de la entrada de cada carril
+  array<uint8_t, L> activos{}; // 1 si el carril tiene una entrada en ejecución (en bytes para operar con ellos sin saltos)
+  vector<vector<uint8_t>> memoria; // Columnas de cada cinta
+  vector<uint8_t*> cabezales;      // Celda bajo el cabezal de cada cinta
+  vector<uint8_t*> primeras;       // Primera y última celda de cada cinta, para saber cuándo ampliarla
+  vector<uint8_t*> ultimas;
+
+  /**
+   * @brief Vuelve a calcular los punteros de la cinta k después de cambiar su memoria
+   */
+  void apuntar(size_t k, size_t cabezal) {
+    primeras[k] = memoria[k].data();
+    ultimas[k] = primeras[k] + memoria[k].size() - 1;
+    cabezales[k] = primeras[k] + cabezal;
+  }
+
+  inline size_t cabezal(size_t k) const { return static_cast<size_t>(cabezales[k] - primeras[k]); }
+
+  /**
+   * @brief Duplica la cinta k por el extremo en el que está el cabezal, para que pueda dar un paso
+   *        más sin salirse
+   */
+  void crecer(size_t k, uint8_t blanco) {
+    vector<uint8_t>& cinta = memoria[k];
+    size_t posicion = cabezal(k), anadidas = cinta.size();
+    if (posicion == 0) {
+      cinta.insert(cinta.begin(), anadidas, blanco);
+      posicion += anadidas;
+    } else {
+      cinta.resize(cinta.size() + anadidas, blanco);
+    }
+    apuntar(k, posicion);
+  }
+};
+
+/**
+ * @brief Método para ejecutar el lote en L carriles que avanzan a la vez, con N cintas (0 si el
+ *        número de cintas solo se conoce en tiempo de ejecución). En cada iteración cada carril da
+ *        un paso en una sola pasada: lee sus celdas, busca la transición en la tabla densa,
+ *        comprueba si termina (con las mismas comprobaciones y en el mismo orden que los núcleos
+ *        del Motor) y escribe, mueve y cambia de estado sin saltos, descartando el efecto en los
+ *        carriles que no dan el paso. Los carriles son independientes, así que el procesador
+ *        solapa las lecturas de unos y otros. Al final se retiran los que terminan y se cargan
+ *        con las siguientes entradas del lote.
+ * @param entradas Cadenas de entrada
+ * @param opciones Opciones de cada ejecución
+ * @param volcarCintas Si es true se rellena ResultadoLote::cintas
+ * @param resultados Resultado de cada entrada
+ * @return void
+ */
+template <size_t L, size_t N>
+void MotorCarriles::ejecutarCarriles(const vector<string>& entradas, const Opciones& opciones, bool volcarCintas, vector<ResultadoLote>& resultados) const {
+  static_assert(L <= 32, "Los carriles libres se guardan en una máscara de 32 bits");
+  const TablaCarriles& tabla = *tabla_;
+  const TablaSimbolos& simbolos = motor_.tablaSimbolos();
+  const size_t numCintas = N > 0 ? N : tabla.numCintas; // Constante en los núcleos especializados
+  const size_t numColumnas = tabla.numColumnas;
+  const long limitePasos = opciones.limitePasos > 0 ? opciones.limitePasos : numeric_limits<long>::max();
+  const atomic<bool>* cancelar = opciones.cancelar;
+  // Punteros a la tabla en variables locales: las escrituras en las cintas (uint8_t) pueden
+  // solaparse con cualquier dato, y si no el compilador volvería a leerlos en cada paso
+  const int32_t* transiciones = tabla.transiciones.data();
+  const uint32_t* destinos = tabla.destinos.data();
+  const uint16_t* acciones = tabla.acciones.data();
+  const uint32_t inactiva = tabla.inactiva;
+
+  // Los carriles sin entrada tienen una cinta en blanco para que leerlos siempre sea válido
+  Carriles<L> c;
+  c.memoria.assign(numCintas * L, vector<uint8_t>(1, tabla.blanco));
+  c.cabezales.resize(numCintas * L);
+  c.primeras.resize(numCintas * L);
+  c.ultimas.resize(numCintas * L);
+  for (size_t k = 0; k < numCintas * L; ++k) {
+    c.apuntar(k, 0);
+  }
+  c.estados.fill(tabla.inicial);
+
+  vector<Simbolo> codigos;
+  size_t siguiente = 0, numActivos = 0;
+  auto cargar = [&](size_t l) { // Carga en el carril l la siguiente entrada válida del lote
+    vector<uint8_t>& primera = c.memoria[l];
+    while (siguiente < entradas.size()) {
+      size_t e = siguiente++;
+      primera.assign(Carriles<L>::MARGEN, tabla.blanco);
+      if (!tabla.codificar(simbolos, entradas[e], codigos, primera)) {
+        resultados[e].veredicto = Veredicto::EntradaInvalida;
+        continue;
+      }
+      primera.resize(primera.size() + Carriles<L>::MARGEN, tabla.blanco);
+      c.apuntar(l, Carriles<L>::MARGEN);
+      for (size_t i = 1; i < numCintas; ++i) {
+        c.memoria[i * L + l].assign(2 * Carriles<L>::MARGEN, tabla.blanco);
+        c.apuntar(i * L + l, Carriles<L>::MARGEN);
+      }
+      c.estados[l] = tabla.inicial;
+      c.pasos[l] = 0;
+      c.entradas[l] = e;
+      c.activos[l] = 1;
+      numActivos++;
+      return;
+    }
+    primera.assign(1, tabla.blanco); // No quedan entradas: el carril se queda con una cinta en blanco
+    c.apuntar(l, 0);
+  };
+  auto retirar = [&](size_t l, Veredicto veredicto) {
+    ResultadoLote& resultado = resultados[c.entradas[l]];
+    resultado.veredicto = veredicto;
+    resultado.pasos = c.pasos[l];
+    auto texto = [&](size_t k, bool marcarCabezal) { return tabla.texto(simbolos, c.memoria[k], static_cast<long>(c.cabezal(k)), marcarCabezal); };
+    if (opciones.conservarCinta) {
+      resultado.cinta = texto(l, false);
+    }
+    for (size_t cinta : opciones.cintasSalida) {
+      resultado.salidas.push_back(texto(cinta * L + l, false));
+    }
+    if (volcarCintas) {
+      for (size_t i = 0; i < numCintas; ++i) {
+        resultado.cintas.push_back(texto(i * L + l, true));
+      }
+    }
+    c.activos[l] = 0;
+    numActivos--;
+  };
+
+  for (size_t l = 0; l < L; ++l) {
+    cargar(l);
+  }
+  uint8_t** cabezales = c.cabezales.data(); // Los arrays de las cintas no cambian de tamaño
+  uint8_t* const* primeras = c.primeras.data();
+  uint8_t* const* ultimas = c.ultimas.data();
+  while (numActivos > 0) {
+    bool cancelada = cancelar != nullptr && cancelar->load(memory_order_relaxed);
+    uint32_t libres = 0, aceptados = 0, enExtremo = 0;
+    for (size_t l = 0; l < L; ++l) {
+      // Transición del carril: índice formado por el estado y las columnas leídas
+      size_t indice = c.estados[l];
+      for (size_t i = 0; i < numCintas; ++i) {
+        indice = indice * numColumnas + *cabezales[i * L + l];
+      }
+      const int32_t transicion = transiciones[indice];
+      const long pasos = c.pasos[l];
+      const uint32_t termina = (transicion < 0) | (pasos >= limitePasos) | (cancelada & ((pasos & 4095) == 0));
+      const uint32_t aplica = c.activos[l] & (termina ^ 1u);
+      libres |= (c.activos[l] & termina) << l;
+
+      // Escritura, movimiento y estado siguiente; con la máscara a 0 se conserva lo que había
+      const uint32_t mascara = 0u - aplica;
+      const uint32_t t = (static_cast<uint32_t>(transicion) & mascara) | (inactiva & ~mascara);
+      for (size_t i = 0; i < numCintas; ++i) {
+        const size_t k = i * L + l;
+        const uint32_t accion = acciones[t * numCintas + i];
+        uint8_t* celda = cabezales[k];
+        *celda = static_cast<uint8_t>((accion & mascara) | (*celda & ~mascara));
+        celda += static_cast<long>((accion >> 8) & mascara) - static_cast<long>(aplica);
+        cabezales[k] = celda;
+        enExtremo |= aplica & ((celda == primeras[k]) | (celda == ultimas[k]));
+      }
+      const uint32_t destino = destinos[t];
+      c.transiciones[l] = transicion;
+      c.pasos[l] = pasos + aplica;
+      c.estados[l] = (destino & 0x7FFFFFFFu & mascara) | (c.estados[l] & ~mascara);
+      aceptados |= ((destino >> 31) & aplica) << l;
+    }
+
+    // Amplío las cintas cuyo cabezal ha llegado a un extremo, de forma que el paso siguiente no
+    // pueda salirse (los carriles inactivos tienen una cinta de una celda y no se amplían)
+    if (enExtremo) {
+      for (size_t k = 0; k < numCintas * L; ++k) {
+        if (c.activos[k % L] && (cabezales[k] == primeras[k] || cabezales[k] == ultimas[k])) {
+          c.crecer(k, tabla.blanco);
+        }
+      }
+    }
+
+    // Retiro los carriles que terminan sin aplicar la transición y los que aceptan
+    for (uint32_t m = libres; m != 0; m &= m - 1) {
+      size_t l = countr_zero(m);
+      if (c.transiciones[l] < 0) {
+        retirar(l, Veredicto::Rechazada);
+      } else if (c.pasos[l] >= limitePasos) {
+        retirar(l, Veredicto::LimitePasos);
+      } else {
+        retirar(l, Veredicto::Cancelada);
+      }
+    }
+    for (uint32_t m = aceptados; m != 0; m &= m - 1) {
+      retirar(countr_zero(m), Veredicto::Aceptada);
+    }
+
+    // Cargo las siguientes entradas en los carriles que han terminado
+    for (uint32_t m = libres | aceptados; m != 0; m &= m - 1) {
+      cargar(countr_zero(m));
+    }
+  }
+}
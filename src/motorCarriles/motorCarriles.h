@@ -0,0 +1,72 @@
+#pragma once
+#include "../motor/motor.h"
+#include <array>
+#include <memory> // Para shared_ptr
+#include <string>
+#include <utility> // Para index_sequence
+#include <vector>
+
+#ifndef MOTORCARRILES_H
+#define MOTORCARRILES_H
+
+using namespace std;
+
+/**
+ * @struct ResultadoLote
+ * @brief Resultado de una de las entradas de un lote
+ */
+struct ResultadoLote {
+  Veredicto veredicto = Veredicto::Rechazada;
+  long pasos = 0;          // Transiciones aplicadas
+  string cinta;            // Cinta 1 sin blancos en los extremos, si Opciones::conservarCinta
+  vector<string> salidas;  // Contenido de Opciones::cintasSalida
+  vector<string> cintas;   // Todas las cintas con el cabezal entre corchetes, solo si se piden (pruebas)
+};
+
+struct TablaCarriles; // Tabla de transiciones densa de la máquina (src/motorCarriles/motorCarriles.cc)
+
+/**
+ * @class MotorCarriles
+ * @brief Ejecuta lotes de entradas cortas de una misma máquina en carriles que avanzan a la vez.
+ *        En cada iteración todos los carriles dan un paso: sus estados, cabezales y pasos están en
+ *        un array por campo y la transición de cada carril se lee de una tabla densa indexada por
+ *        el estado y los símbolos leídos, sin recorrer las transiciones del estado. Cuando un
+ *        carril termina se carga en él la siguiente entrada del lote. Si la tabla densa no cabe
+ *        (demasiados estados, símbolos o cintas) o se pide el registro de vuelo, cada entrada se
+ *        ejecuta con el Motor. Como el Motor, es inmutable y puede usarse desde varios hilos.
+ */
+class MotorCarriles {
+  public:
+    static constexpr size_t MAX_ENTRADAS_TABLA = size_t{1} << 20; // Entradas de la tabla densa
+
+    // Constructor y destructor (lanza invalid_argument si numCarriles no es 8, 16 o 32)
+    explicit MotorCarriles(Motor motor, size_t numCarriles = 16);
+    ~MotorCarriles() = default;
+
+    // Métodos
+    vector<ResultadoLote> ejecutarLote(const vector<string>& entradas, const Opciones& opciones = {}, bool volcarCintas = false) const;
+
+    // Getters
+    inline bool enCarriles() const { return tabla_ != nullptr; } // false si las entradas se ejecutan con el Motor
+    inline size_t numCarriles() const { return numCarriles_; }
+    inline const Motor& motor() const { return motor_; }
+
+  private:
+    using Nucleo = void (MotorCarriles::*)(const vector<string>& entradas, const Opciones& opciones, bool volcarCintas, vector<ResultadoLote>& resultados) const;
+
+    void ejecutarConMotor(const vector<string>& entradas, const Opciones& opciones, bool volcarCintas, vector<ResultadoLote>& resultados) const;
+
+    // Núcleos de ejecución: uno por número de carriles y de cintas hasta MAX_CINTAS_ESPECIALIZADAS
+    // (N = 0 recorre las cintas en tiempo de ejecución)
+    static constexpr size_t MAX_CINTAS_ESPECIALIZADAS = 4;
+    template <size_t L, size_t N> void ejecutarCarriles(const vector<string>& entradas, const Opciones& opciones, bool volcarCintas, vector<ResultadoLote>& resultados) const;
+    template <size_t L, size_t... I> static constexpr array<Nucleo, sizeof...(I)> tablaNucleos(index_sequence<I...>);
+    template <size_t L> static Nucleo elegirNucleo(size_t numCintas);
+
+    Motor motor_;
+    shared_ptr<const TablaCarriles> tabla_; // nullptr si la máquina no cabe en la tabla densa
+    size_t numCarriles_;
+    Nucleo nucleo_ = nullptr; // Núcleo elegido al construir, si la máquina cabe en la tabla densa
+};
+
+#endif // MOTORCARRILES_H
@@ -0,0 +1,126 @@
+#include "programa.h"
+#include "../tools/tools.h"
+#include <cstring> // Para memcpy
+#include <memory> // Para unique_ptr
+#include <unordered_map>
+
+/**
+ * @brief Función para redondear un desplazamiento al alineamiento de un tipo
+ */
+static size_t alinear(size_t desplazamiento, size_t alineamiento) {
+  return (desplazamiento + alineamiento - 1) / alineamiento * alineamiento;
+}
+
+/**
+ * @brief Carga una máquina desde un fichero con el formato de /data
+ * @param nombreFichero Nombre del fichero
+ * @return Programa con la máquina cargada
+ */
+Programa Programa::desdeFichero(const string& nombreFichero) {
+  ifstream file(nombreFichero);
+  if (!file.is_open()) { // Comprobar la lectura del fichero
+    throw runtime_error("No se pudo abrir el fichero: " + nombreFichero);
+  }
+  return desdeFlujo(file);
+}
+
+/**
+ * @brief Carga una máquina desde un flujo. Las transiciones se reciben ya validadas de
+ *        leerFlujo sin crear objetos Transicion, y al terminar se colocan agrupadas por
+ *        estado en la arena.
+ * @param flujo Flujo con el formato de los ficheros de /data
+ * @return Programa con la máquina cargada
+ */
+Programa Programa::desdeFlujo(istream& flujo) {
+  vector<const Estado*> origenes, destinos;
+  vector<int32_t> ids;
+  vector<Simbolo> simbolos;
+  vector<char> movimientos;
+  Tools datos = leerFlujo(flujo, [&](const TransicionLeida& t) {
+    origenes.push_back(t.actual);
+    destinos.push_back(t.siguiente);
+    ids.push_back(t.id);
+    simbolos.insert(simbolos.end(), t.lectura.begin(), t.lectura.end());
+    simbolos.insert(simbolos.end(), t.escritura.begin(), t.escritura.end());
+    movimientos.insert(movimientos.end(), t.movimiento.begin(), t.movimiento.end());
+  });
+  // Los estados leídos solo sirven para construir el programa: se liberan al salir, también si falla
+  unique_ptr<Tools, void (*)(Tools*)> liberar(&datos, [](Tools* leidos) { liberarEstados(*leidos); });
+
+  Programa programa;
+  programa.tabla_ = *datos.simbolos;
+  programa.numCintas_ = datos.numCintas;
+  programa.numEstados_ = static_cast<uint32_t>(datos.estados.size());
+  programa.numTransiciones_ = static_cast<uint32_t>(ids.size());
+  const size_t numCintas = static_cast<size_t>(datos.numCintas);
+  const size_t anchura = programa.tabla_.anchura();
+
+  unordered_map<const Estado*, uint32_t> indices;
+  size_t tamNombres = 0;
+  for (const Estado* estado : datos.estados) {
+    indices.emplace(estado, static_cast<uint32_t>(indices.size()));
+    tamNombres += estado->getId().size();
+  }
+
+  // Distribución de la arena: estados | transiciones | símbolos | movimientos | nombres
+  size_t inicioTransiciones = alinear(programa.numEstados_ * sizeof(RegistroEstado), alignof(RegistroTransicion));
+  size_t inicioSimbolos = inicioTransiciones + programa.numTransiciones_ * sizeof(RegistroTransicion);
+  size_t inicioMovimientos = inicioSimbolos + programa.numTransiciones_ * 2 * numCintas * anchura;
+  size_t inicioNombres = inicioMovimientos + programa.numTransiciones_ * numCintas;
+  programa.tamArena_ = inicioNombres + tamNombres;
+  programa.arena_ = make_unique<byte[]>(programa.tamArena_);
+
+  auto* estados = reinterpret_cast<RegistroEstado*>(programa.arena_.get());
+  auto* transiciones = reinterpret_cast<RegistroTransicion*>(programa.arena_.get() + inicioTransiciones);
+  byte* simbolosArena = programa.arena_.get() + inicioSimbolos;
+  auto* movimientosArena = reinterpret_cast<char*>(programa.arena_.get() + inicioMovimientos);
+  auto* nombres = reinterpret_cast<char*>(programa.arena_.get() + inicioNombres);
+
+  // Estados: cuento sus transiciones y copio sus identificadores
+  vector<uint32_t> siguienteLibre(programa.numEstados_, 0);
+  for (const Estado* origen : origenes) {
+    siguienteLibre[indices.at(origen)]++;
+  }
+  uint32_t primera = 0, nombre = 0;
+  for (uint32_t i = 0; i < programa.numEstados_; ++i) {
+    const Estado* estado = datos.estados[i];
+    const string& id = estado->getId();
+    estados[i] = RegistroEstado{primera, siguienteLibre[i], nombre, static_cast<uint32_t>(id.size()), estado->esAceptacion()};
+    memcpy(nombres + nombre, id.data(), id.size());
+    nombre += static_cast<uint32_t>(id.size());
+    siguienteLibre[i] = primera;
+    primera += estados[i].numTransiciones;
+    if (estado->esInicial()) {
+      programa.inicial_ = i;
+    }
+  }
+
+  // Transiciones: agrupadas por estado conservando el orden del fichero
+  for (size_t t = 0; t < ids.size(); ++t) {
+    uint32_t posicion = siguienteLibre[indices.at(origenes[t])]++;
+    transiciones[posicion] = RegistroTransicion{indices.at(destinos[t]), ids[t]};
+    for (size_t i = 0; i < 2 * numCintas; ++i) {
+      Simbolo simbolo = simbolos[t * 2 * numCintas + i];
+      if (anchura == 1) {
+        reinterpret_cast<char*>(simbolosArena)[posicion * 2 * numCintas + i] = static_cast<char>(simbolo);
+      } else {
+        reinterpret_cast<uint16_t*>(simbolosArena)[posicion * 2 * numCintas + i] = simbolo;
+      }
+    }
+    memcpy(movimientosArena + posicion * numCintas, movimientos.data() + t * numCintas, numCintas);
+  }
+
+  // La entrada admite los símbolos de Σ y el blanco, como MaquinaTuring::esValida
+  programa.entradaValida_.assign(size_t{1} << (8 * anchura), 0);
+  for (size_t c = 0; c < programa.tabla_.numCodigos(); ++c) {
+    Simbolo simbolo = static_cast<Simbolo>(c);
+    programa.entradaValida_[c] = datos.alfabetos.first.pertenece(simbolo) || simbolo == '.';
+  }
+
+  programa.estados_ = estados;
+  programa.transiciones_ = transiciones;
+  programa.simbolos_ = simbolosArena;
+  programa.movimientos_ = movimientosArena;
+  programa.nombres_ = nombres;
+  return programa;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "../simbolos/simbolos.h"
+#include <cstddef> // Para std::byte
+#include <cstdint>
+#include <istream>
+#include <memory> // Para unique_ptr
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef PROGRAMA_H
+#define PROGRAMA_H
+
+using namespace std;
+
+/**
+ * @struct RegistroEstado
+ * @brief Estado dentro de la arena: sus transiciones son las del rango
+ *        [primeraTransicion, primeraTransicion + numTransiciones) en el orden del fichero
+ */
+struct RegistroEstado {
+  uint32_t primeraTransicion;
+  uint32_t numTransiciones;
+  uint32_t nombre;         // Desplazamiento del identificador en el array de nombres
+  uint32_t longitudNombre;
+  bool aceptacion;
+};
+
+/**
+ * @struct RegistroTransicion
+ * @brief Transición dentro de la arena. Sus símbolos de lectura y escritura ocupan 2 * numCintas
+ *        códigos consecutivos del array de símbolos, y sus movimientos numCintas posiciones del
+ *        array de movimientos.
+ */
+struct RegistroTransicion {
+  uint32_t siguiente; // Índice del estado siguiente
+  int32_t id;         // Identificador de la transición (orden en el fichero)
+};
+
+/**
+ * @class Programa
+ * @brief Definición inmutable de una máquina almacenada en una única reserva de memoria (arena)
+ *        con los estados, las transiciones, los símbolos, los movimientos y los identificadores de
+ *        los estados en arrays contiguos. Se libera de una sola vez al destruir el programa. Los
+ *        símbolos se guardan con la anchura de su tabla de símbolos: char (8 bits) o uint16_t.
+ */
+class Programa {
+  public:
+    // Constructor y destructor
+    Programa() = default;
+    Programa(Programa&&) = default;
+    Programa& operator=(Programa&&) = default;
+    ~Programa() = default;
+
+    // Carga de la máquina (lanza runtime_error si la definición no es válida)
+    static Programa desdeFichero(const string& nombreFichero);
+    static Programa desdeFlujo(istream& flujo);
+
+    // Getters
+    inline const RegistroEstado& estado(uint32_t i) const { return estados_[i]; }
+    inline const RegistroTransicion& transicion(uint32_t t) const { return transiciones_[t]; }
+    template <typename S> inline const S* lectura(uint32_t t) const { return reinterpret_cast<const S*>(simbolos_) + static_cast<size_t>(t) * 2 * numCintas_; }
+    template <typename S> inline const S* escritura(uint32_t t) const { return lectura<S>(t) + numCintas_; }
+    inline const char* movimientos(uint32_t t) const { return movimientos_ + static_cast<size_t>(t) * numCintas_; }
+    inline string_view nombre(uint32_t i) const { return string_view(nombres_ + estados_[i].nombre, estados_[i].longitudNombre); }
+    inline uint32_t inicial() const { return inicial_; }
+    inline int numCintas() const { return numCintas_; }
+    inline uint32_t numEstados() const { return numEstados_; }
+    inline uint32_t numTransiciones() const { return numTransiciones_; }
+    inline const vector<uint8_t>& entradaValida() const { return entradaValida_; } // Indexada por código
+    inline const TablaSimbolos& tablaSimbolos() const { return tabla_; }
+    inline size_t anchura() const { return tabla_.anchura(); } // Bytes por símbolo en las cintas
+    inline size_t memoria() const { return sizeof(Programa) + tamArena_ + tabla_.memoria() + entradaValida_.size(); } // Bytes ocupados por la máquina
+
+  private:
+    unique_ptr<byte[]> arena_;
+    size_t tamArena_ = 0;
+    const RegistroEstado* estados_ = nullptr;
+    const RegistroTransicion* transiciones_ = nullptr;
+    const byte* simbolos_ = nullptr;
+    const char* movimientos_ = nullptr;
+    const char* nombres_ = nullptr;
+    uint32_t numEstados_ = 0;
+    uint32_t numTransiciones_ = 0;
+    uint32_t inicial_ = 0;
+    int numCintas_ = 1;
+    TablaSimbolos tabla_;
+    vector<uint8_t> entradaValida_; // Un elemento por cada código de la anchura de la máquina
+};
+
+#endif // PROGRAMA_H
@@ -0,0 +1,90 @@
+#include "registroVuelo.h"
+#include "../cintaSegmentada/cintaSegmentada.h"
+#include <stdexcept> // Para las excepciones
+#include <unordered_map>
+
+/**
+ * @brief Método para reservar el buffer y vaciarlo antes de una ejecución
+ * @param capacidad Número de configuraciones que se conservan (0 desactiva el registro)
+ * @param numCintas Número de cintas de la máquina
+ * @param radio Celdas a cada lado del cabezal que se muestran de cada cinta (lanza
+ *        invalid_argument si es negativo y el registro está activado)
+ * @return void
+ */
+void RegistroVuelo::preparar(size_t capacidad, size_t numCintas, int radio) {
+  if (capacidad > 0 && radio < 0) {
+    throw invalid_argument("El radio del registro de vuelo no puede ser negativo: " + to_string(radio));
+  }
+  capacidad_ = capacidad;
+  numCintas_ = numCintas;
+  radio_ = radio;
+  siguiente_ = 0;
+  total_ = 0;
+  entradas_.resize(capacidad_);
+  huellas_.resize(capacidad_ * numCintas_);
+  ventanas_.clear();
+}
+
+/**
+ * @brief Método para reconstruir las ventanas de las configuraciones registradas. Se parte de
+ *        las cintas al terminar la ejecución y se deshacen los pasos del más reciente al más
+ *        antiguo, volviendo a escribir en cada cabezal el símbolo leído en ese paso (en el
+ *        último paso, si no llegó a aplicarse, esto no cambia nada).
+ * @param cintas Cintas al terminar la ejecución
+ * @return void
+ */
+template <typename S>
+void RegistroVuelo::reconstruirVentanas(const vector<CintaSegmentada<S>>& cintas) {
+  ventanas_.assign(size() * numCintas_ * anchoVentana(), '.');
+  for (size_t cinta = 0; cinta < numCintas_; ++cinta) {
+    unordered_map<long, Simbolo> deshechas; // Celdas cuyo contenido difiere del de la cinta final
+    const long primera = cintas[cinta].primeraCelda(), ultima = cintas[cinta].ultimaCelda();
+    for (size_t i = size(); i-- > 0;) {
+      const Huella& huella = huellas_[hueco(i) * numCintas_ + cinta];
+      deshechas[huella.cabezal] = huella.leido;
+      Simbolo* ventana = ventanas_.data() + (i * numCintas_ + cinta) * anchoVentana();
+      for (long posicion = huella.cabezal - radio_; posicion <= huella.cabezal + radio_; ++posicion) {
+        auto it = deshechas.find(posicion);
+        if (it != deshechas.end()) {
+          *ventana = it->second;
+        } else if (posicion >= primera && posicion <= ultima) {
+          *ventana = codigoDe(cintas[cinta].celda(posicion));
+        }
+        ventana++;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Método para obtener la posición en el buffer de la configuración i
+ * @param i Configuración, empezando por la más antigua que se conserva
+ * @return Hueco del buffer
+ */
+size_t RegistroVuelo::hueco(size_t i) const {
+  size_t primera = total_ < capacidad_ ? 0 : siguiente_;
+  return (primera + i) % capacidad_;
+}
+
+/**
+ * @brief Método para obtener una configuración del registro
+ * @param i Configuración, empezando por la más antigua que se conserva
+ * @return Configuración registrada
+ */
+const ConfiguracionRegistrada& RegistroVuelo::configuracion(size_t i) const {
+  return entradas_[hueco(i)];
+}
+
+/**
+ * @brief Método para obtener la ventana de una cinta en una configuración del registro
+ * @param i Configuración, empezando por la más antigua que se conserva
+ * @param cinta Cinta (empezando en 0)
+ * @return Códigos de las celdas de la ventana; el cabezal está en la posición getRadio()
+ */
+const Simbolo* RegistroVuelo::ventana(size_t i, size_t cinta) const {
+  return ventanas_.data() + (i * numCintas_ + cinta) * anchoVentana();
+}
+
+// Anchuras de símbolo que usan las máquinas
+template void RegistroVuelo::reconstruirVentanas(const vector<CintaSegmentada<char>>& cintas);
+template void RegistroVuelo::reconstruirVentanas(const vector<CintaSegmentada<uint16_t>>& cintas);
@@ -0,0 +1,78 @@
+#pragma once
+#include "../simbolos/simbolos.h"
+#include <cstdint>
+#include <vector>
+
+#ifndef REGISTROVUELO_H
+#define REGISTROVUELO_H
+
+using namespace std;
+
+template <typename S> class CintaSegmentada;
+
+/**
+ * @struct ConfiguracionRegistrada
+ * @brief Configuración guardada en el registro de vuelo
+ */
+struct ConfiguracionRegistrada {
+  long paso;          // Pasos aplicados antes de esta configuración
+  uint32_t estado;    // Índice del estado en el Programa
+  int32_t transicion; // Identificador de la transición aplicable, -1 si no hay ninguna
+};
+
+/**
+ * @struct Huella
+ * @brief Lo que se anota de cada cinta en cada paso: el cabezal y el símbolo leído, que es
+ *        el que había antes de escribir y permite deshacer el paso
+ */
+struct Huella {
+  long cabezal;
+  Simbolo leido;
+};
+
+/**
+ * @class RegistroVuelo
+ * @brief Buffer circular con las últimas configuraciones de una ejecución: estado, transición
+ *        y una ventana de cada cinta alrededor de su cabezal. Toda la memoria se reserva en
+ *        preparar() y en cada paso solo se anota el estado, la transición y una Huella por
+ *        cinta. Las ventanas se reconstruyen al final deshaciendo los pasos sobre las cintas.
+ */
+class RegistroVuelo {
+  public:
+    // Constructor y destructor
+    RegistroVuelo() = default;
+    ~RegistroVuelo() = default;
+
+    // Métodos
+    void preparar(size_t capacidad, size_t numCintas, int radio);
+    inline Huella* anotar(long paso, uint32_t estado, int32_t transicion) { // Devuelve dónde anotar las cintas
+      size_t hueco = siguiente_;
+      entradas_[hueco] = ConfiguracionRegistrada{paso, estado, transicion};
+      siguiente_ = siguiente_ + 1 == capacidad_ ? 0 : siguiente_ + 1;
+      total_++;
+      return huellas_.data() + hueco * numCintas_;
+    }
+    template <typename S> void reconstruirVentanas(const vector<CintaSegmentada<S>>& cintas);
+
+    // Getters
+    inline bool activo() const { return capacidad_ > 0; }
+    inline size_t size() const { return total_ < capacidad_ ? total_ : capacidad_; }
+    inline int getRadio() const { return radio_; }
+    inline size_t anchoVentana() const { return 2 * static_cast<size_t>(radio_) + 1; }
+    const ConfiguracionRegistrada& configuracion(size_t i) const; // i = 0 es la más antigua
+    const Simbolo* ventana(size_t i, size_t cinta) const;          // Necesita reconstruirVentanas()
+
+  private:
+    size_t hueco(size_t i) const;
+
+    vector<ConfiguracionRegistrada> entradas_;
+    vector<Huella> huellas_;
+    vector<Simbolo> ventanas_; // Ventanas reconstruidas, en el orden de configuracion(i)
+    size_t capacidad_ = 0;
+    size_t numCintas_ = 0;
+    int radio_ = 0;
+    size_t siguiente_ = 0;
+    size_t total_ = 0;
+};
+
+#endif // REGISTROVUELO_H
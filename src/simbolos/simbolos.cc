@@ -0,0 +1,128 @@
+#include "simbolos.h"
+#include <array>
+#include <cctype> // Para isspace
+#include <stdexcept> // Para las excepciones
+
+/**
+ * @brief Constructor de la clase TablaSimbolos
+ * @param simbolos Símbolos de los alfabetos (Σ y Γ). Los repetidos y el blanco ('.') se ignoran.
+ */
+TablaSimbolos::TablaSimbolos(const vector<string>& simbolos) {
+  for (const string& simbolo : simbolos) {
+    if (simbolo.size() != 1) {
+      directa_ = false;
+    }
+  }
+  if (directa_) {
+    return;
+  }
+
+  // Codificación densa: el blanco ocupa el código '.' y el resto se numeran saltándolo
+  tokens_.resize('.' + 1);
+  tokens_['.'] = ".";
+  codigos_.emplace(".", '.');
+  size_t siguiente = 0;
+  for (const string& simbolo : simbolos) {
+    if (codigos_.count(simbolo) > 0) {
+      continue;
+    }
+    if (siguiente == '.') {
+      siguiente++;
+    }
+    if (siguiente >= MAX_SIMBOLOS) {
+      throw runtime_error("La máquina tiene más de " + to_string(MAX_SIMBOLOS) + " símbolos.");
+    }
+    if (siguiente >= tokens_.size()) {
+      tokens_.resize(siguiente + 1);
+    }
+    tokens_[siguiente] = simbolo;
+    codigos_.emplace(simbolo, static_cast<Simbolo>(siguiente));
+    siguiente++;
+  }
+}
+
+/**
+ * @brief Método para obtener el código de un símbolo
+ * @param simbolo Símbolo a buscar
+ * @param codigo Código del símbolo si se encuentra
+ * @return true si el símbolo tiene código, false en caso contrario
+ */
+bool TablaSimbolos::buscar(string_view simbolo, Simbolo& codigo) const {
+  if (directa_) {
+    codigo = simbolo.size() == 1 ? codigoDe(simbolo[0]) : 0;
+    return simbolo.size() == 1;
+  }
+  auto it = codigos_.find(string(simbolo));
+  if (it == codigos_.end()) {
+    return false;
+  }
+  codigo = it->second;
+  return true;
+}
+
+/**
+ * @brief Método para codificar una cadena: carácter a carácter en la codificación directa y
+ *        símbolo a símbolo (separados por espacios) en la densa
+ * @param cadena Cadena a codificar
+ * @param codigos Códigos de la cadena, reutilizando su memoria
+ * @return true si todos los símbolos tienen código, false en caso contrario
+ */
+bool TablaSimbolos::codificar(string_view cadena, vector<Simbolo>& codigos) const {
+  codigos.clear();
+  if (directa_) {
+    codigos.reserve(cadena.size());
+    for (char simbolo : cadena) {
+      codigos.push_back(codigoDe(simbolo));
+    }
+    return true;
+  }
+  string simbolo;
+  size_t i = 0;
+  while (i < cadena.size()) {
+    if (isspace(static_cast<unsigned char>(cadena[i]))) {
+      i++;
+      continue;
+    }
+    size_t fin = i;
+    while (fin < cadena.size() && !isspace(static_cast<unsigned char>(cadena[fin]))) {
+      fin++;
+    }
+    simbolo.assign(cadena.substr(i, fin - i));
+    auto it = codigos_.find(simbolo);
+    if (it == codigos_.end()) {
+      return false;
+    }
+    codigos.push_back(it->second);
+    i = fin;
+  }
+  return true;
+}
+
+/**
+ * @brief Método para obtener el símbolo de un código
+ * @param codigo Código del símbolo
+ * @return Texto del símbolo
+ */
+string_view TablaSimbolos::token(Simbolo codigo) const {
+  static const array<char, 256> bytes = [] {
+    array<char, 256> todos;
+    for (int c = 0; c < 256; ++c) todos[c] = static_cast<char>(c);
+    return todos;
+  }();
+  if (directa_) {
+    return string_view(&bytes[codigo & 0xFF], 1);
+  }
+  return tokens_[codigo];
+}
+
+/**
+ * @brief Método para obtener la memoria ocupada por la tabla
+ * @return Bytes ocupados, aproximados (sin contar la gestión interna del mapa)
+ */
+size_t TablaSimbolos::memoria() const {
+  size_t memoria = tokens_.capacity() * sizeof(string) + codigos_.size() * (sizeof(string) + sizeof(Simbolo));
+  for (const string& token : tokens_) {
+    memoria += token.size();
+  }
+  return memoria;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits> // Para make_unsigned_t
+#include <unordered_map>
+#include <vector>
+
+#ifndef SIMBOLOS_H
+#define SIMBOLOS_H
+
+using namespace std;
+
+using Simbolo = uint16_t; // Código de un símbolo internado
+
+/**
+ * @brief Código del símbolo guardado en una celda de 8 (char) o de 16 bits
+ */
+template <typename S>
+inline Simbolo codigoDe(S simbolo) { return static_cast<make_unsigned_t<S>>(simbolo); }
+
+/**
+ * @class TablaSimbolos
+ * @brief Símbolos de una máquina internados en códigos enteros. Si todos los símbolos tienen un
+ *        solo carácter la codificación es directa: el código es el propio byte y las cadenas se
+ *        leen carácter a carácter. Si no, cada símbolo recibe un código denso por orden de
+ *        aparición y las cadenas se escriben con los símbolos separados por espacios. En las dos
+ *        codificaciones el blanco tiene el código '.', y la anchura (8 o 16 bits) es la menor en
+ *        la que caben todos los códigos.
+ */
+class TablaSimbolos {
+  public:
+    static constexpr size_t MAX_SIMBOLOS = 65536;
+
+    // Constructor y destructor
+    TablaSimbolos() = default;
+    explicit TablaSimbolos(const vector<string>& simbolos); // Lanza runtime_error si hay demasiados símbolos
+    ~TablaSimbolos() = default;
+
+    // Métodos
+    bool buscar(string_view simbolo, Simbolo& codigo) const;
+    bool codificar(string_view cadena, vector<Simbolo>& codigos) const; // false si algún símbolo no existe
+    inline void anadir(string& destino, Simbolo codigo, bool cabezal = false) const { // Añade el símbolo a un texto
+      if (!directa_ && !destino.empty()) destino += ' ';
+      if (cabezal) destino += '[';
+      destino += token(codigo);
+      if (cabezal) destino += ']';
+    }
+
+    // Getters
+    string_view token(Simbolo codigo) const;
+    inline bool directa() const { return directa_; }
+    inline size_t numCodigos() const { return directa_ ? 256 : tokens_.size(); } // Los códigos están en [0, numCodigos())
+    inline size_t anchura() const { return numCodigos() <= 256 ? 1 : 2; } // Bytes por código
+    size_t memoria() const; // Bytes ocupados, aproximados
+
+    // Sobrecarga de operadores
+    friend bool operator==(const TablaSimbolos& a, const TablaSimbolos& b) { return a.directa_ == b.directa_ && a.tokens_ == b.tokens_; }
+
+  private:
+    bool directa_ = true;
+    vector<string> tokens_;                  // Símbolo de cada código (solo en la codificación densa)
+    unordered_map<string, Simbolo> codigos_; // Código de cada símbolo (solo en la codificación densa)
+};
+
+#endif // SIMBOLOS_H
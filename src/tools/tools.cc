@@ -1,6 +1,9 @@
 #include "tools.h"
+#include <algorithm> // Para find
+#include <unordered_map>
 
 static Tools datos; // Variable global para almacenar los datos leídos
+static unordered_map<string, Estado*> indiceEstados; // Estados por identificador
 
 /**
  * @brief Dunción para leer el fichero de entrada y almacenar los datos en una estructura Tools
@@ -13,7 +16,34 @@ Tools leerFichero(const string& nombreFichero) {
   if (!file.is_open()) { // Comprobar la lectura del fichero
     throw runtime_error("No se pudo abrir el fichero: " + nombreFichero);
   }
+  return leerFlujo(file);
+}
+
+/**
+ * @brief Función para leer el número de cintas de la definición
+ * @param linea Línea con el número de cintas
+ * @return Número de cintas (lanza runtime_error si no es un número mayor que 0)
+ */
+static int leerNumCintas(const string& linea) {
+  int numCintas = 0;
+  try {
+    numCintas = stoi(linea);
+  } catch (const logic_error&) { // invalid_argument u out_of_range
+    throw runtime_error("El número de cintas no es válido: " + linea);
+  }
+  if (numCintas < 1) {
+    throw runtime_error("La máquina debe tener al menos una cinta: " + linea);
+  }
+  return numCintas;
+}
 
+/**
+ * @brief Función para leer los datos de la definición en la variable global datos
+ * @param file Flujo de entrada con el formato de los ficheros de /data
+ * @param receptor Si se indica, recibe las transiciones en lugar de agregarlas a los estados
+ * @return void
+ */
+static void leerDefinicion(istream& file, const ReceptorTransiciones& receptor) {
   string linea;
   // Saltar los comentarios y líneas vacías
   while (getline(file, linea)) {
@@ -25,42 +55,70 @@ Tools leerFichero(const string& nombreFichero) {
   // Leo los estados
   leerEstados(istringstream(linea));
 
-  // Leo el alfabeto de entrada
+  // Leo el alfabeto de entrada y el de la cinta
+  string lineaCinta;
   getline(file, linea);
-  leerAlfabeto(istringstream(linea));
-
-  // Leo el alfabeto de la cinta
-  getline(file, linea);
-  leerAlfabeto(istringstream(linea));
+  getline(file, lineaCinta);
+  leerAlfabetos(istringstream(linea), istringstream(lineaCinta));
 
   // Leo el estado inicial
   getline(file, linea);
   comprobarEstado(linea);
-  for (Estado* estado : datos.estados) {
-    if (estado->getId() == linea) {
-      estado->setInicial();
-      break;
-    }
-  }
+  buscarEstado(linea)->setInicial();
 
   // Leo el simbolo blanco de la máquina
   getline(file, linea);
-  comprobarSimboloCinta(linea[0]);
+  istringstream blanco(linea);
+  comprobarSimboloCinta(leerSimbolo(blanco));
 
   // Leo el conjunto de estados finales
   getline(file, linea);
   leerEstadosFinales(istringstream(linea));
 
-  // Leo las transiciones y el número de cintas
-  datos.numCintas = getline(file, linea) ? stoi(linea) : 1;
+  // Leo el número de cintas y las transiciones
+  datos.numCintas = getline(file, linea) ? leerNumCintas(linea) : 1;
   int id = 1;
   while (getline(file, linea)) {
     if (linea.empty() || linea[0] == '#') {
       continue;
     }
-    leerTransiciones(istringstream(linea), id++, datos.numCintas);
+    leerTransiciones(istringstream(linea), id++, datos.numCintas, receptor);
+  }
+}
+
+/**
+ * @brief Función para leer la definición de una máquina desde un flujo (fichero o memoria)
+ * @param file Flujo de entrada con el formato de los ficheros de /data
+ * @param receptor Si se indica, recibe las transiciones en lugar de agregarlas a los estados
+ * @return Estructura Tools con los datos leídos, cuyos estados libera quien la recibe
+ */
+Tools leerFlujo(istream& file, const ReceptorTransiciones& receptor) {
+  datos = Tools(); // Descarto los datos de una lectura anterior
+  indiceEstados.clear();
+  try {
+    leerDefinicion(file, receptor);
+  } catch (...) {
+    // Si la definición no es válida, libero los estados ya creados antes de propagar el error
+    liberarEstados(datos);
+    indiceEstados.clear();
+    throw;
   }
-  return datos;
+  indiceEstados.clear();
+  Tools leidos = std::move(datos);
+  datos = Tools(); // La variable global no se queda con los estados, que ya son de quien los recibe
+  return leidos;
+}
+
+/**
+ * @brief Función para liberar los estados leídos (y sus transiciones)
+ * @param datos Datos devueltos por leerFichero o leerFlujo
+ * @return void
+ */
+void liberarEstados(Tools& datos) {
+  for (Estado* estado : datos.estados) {
+    delete estado;
+  }
+  datos.estados.clear();
 }
 
 /**
@@ -70,11 +128,10 @@ Tools leerFichero(const string& nombreFichero) {
  */
 void leerEstados(istringstream is) {
   string linea;
-  vector<Estado*> estados;
   while (is >> linea) {
-    estados.push_back(new Estado(linea));
+    datos.estados.push_back(new Estado(linea)); // En datos desde el principio, para liberarlo si la lectura falla
+    indiceEstados.emplace(linea, datos.estados.back()); // Si se repite, se queda el primero
   }
-  datos.estados = estados;
 }
 
 /**
@@ -86,37 +143,55 @@ void leerEstadosFinales(istringstream is) {
   string linea;
   while (is >> linea) {
     comprobarEstado(linea);
-    for (Estado* estado : datos.estados) {
-      if (estado->getId() == linea) {
-        if (estado->esInicial()) {
-          throw runtime_error("El estado " + linea + " es inicial y no puede ser de aceptación.");
-        } else {
-          estado->setAceptacion();
-        }
-      }
+    Estado* estado = buscarEstado(linea);
+    if (estado->esInicial()) {
+      throw runtime_error("El estado " + linea + " es inicial y no puede ser de aceptación.");
+    } else {
+      estado->setAceptacion();
     }
   }
 }
 
 /**
- * @brief Función para leer los alfabetos del fichero
- * @param is Stream de entrada
+ * @brief Función para leer los alfabetos del fichero. Los símbolos pueden tener varios
+ *        caracteres y se internan en la tabla de símbolos antes de crear los alfabetos.
+ * @param entrada Stream con el alfabeto de entrada (Σ)
+ * @param cinta Stream con el alfabeto de la cinta (Γ)
  * @return void
  */
-void leerAlfabeto(istringstream is) {
+void leerAlfabetos(istringstream entrada, istringstream cinta) {
+  vector<string> simbolosEntrada, simbolosCinta;
   string linea;
-  Alfabeto alfabeto;
-  while (is >> linea) {
-    alfabeto.insertar(linea[0]);
+  while (entrada >> linea) {
+    simbolosEntrada.push_back(linea);
   }
-  if (datos.alfabetos.first.size() == 0) {
-    // Comprobar que el alfabeto de entrada no contiene epsilon ('.')
-    if (alfabeto.pertenece('.')) {
-      throw runtime_error("El símbolo epsilon ('.') no puede pertenecer al alfabeto de entrada (Σ).");
+  while (cinta >> linea) {
+    simbolosCinta.push_back(linea);
+  }
+  // Comprobar que el alfabeto de entrada no contiene epsilon ('.')
+  if (find(simbolosEntrada.begin(), simbolosEntrada.end(), ".") != simbolosEntrada.end()) {
+    throw runtime_error("El símbolo epsilon ('.') no puede pertenecer al alfabeto de entrada (Σ).");
+  }
+
+  // Comprobar que Σ está contenido en Γ: la cadena de entrada se escribe en la cinta
+  for (const string& simbolo : simbolosEntrada) {
+    if (find(simbolosCinta.begin(), simbolosCinta.end(), simbolo) == simbolosCinta.end()) {
+      throw runtime_error("El símbolo '" + simbolo + "' de Σ no pertenece al alfabeto de la cinta (Γ).");
     }
-    datos.alfabetos.first = alfabeto;
-  } else {
-    datos.alfabetos.second = alfabeto;
+  }
+
+  vector<string> simbolos = simbolosEntrada;
+  simbolos.insert(simbolos.end(), simbolosCinta.begin(), simbolosCinta.end());
+  datos.simbolos = make_shared<const TablaSimbolos>(simbolos);
+  datos.alfabetos = {Alfabeto(datos.simbolos), Alfabeto(datos.simbolos)};
+  Simbolo codigo;
+  for (const string& simbolo : simbolosEntrada) {
+    datos.simbolos->buscar(simbolo, codigo);
+    datos.alfabetos.first.insertar(codigo);
+  }
+  for (const string& simbolo : simbolosCinta) {
+    datos.simbolos->buscar(simbolo, codigo);
+    datos.alfabetos.second.insertar(codigo);
   }
 }
 
@@ -124,11 +199,14 @@ void leerAlfabeto(istringstream is) {
  * @brief Función para leer las transiciones del fichero
  * @param is Stream de entrada
  * @param id Identificador de la transición
+ * @param numCintas Número de cintas
+ * @param receptor Si se indica, recibe la transición en lugar de agregarla al estado
  * @return void
  */
-void leerTransiciones(istringstream is, int id, int numCintas) {
+void leerTransiciones(istringstream is, int id, int numCintas, const ReceptorTransiciones& receptor) {
   string actual, siguiente, linea;
-  vector<char> lecturaCintas, escrituraCintas, movimientoCintas;
+  vector<Simbolo> lecturaCintas, escrituraCintas;
+  vector<char> movimientoCintas;
   is >> actual;
 
   lecturaCintas = leerSimbolosLectura(is, numCintas);
@@ -136,26 +214,46 @@ void leerTransiciones(istringstream is, int id, int numCintas) {
   is >> siguiente;
 
   // Leo los simbolos de escritura y movimientos
-  vector<pair<char, char>> movimientos = leerMovimientos(is, numCintas);
+  vector<pair<Simbolo, char>> movimientos = leerMovimientos(is, numCintas);
   for (const auto& [simbolo, movimiento] : movimientos) {
     escrituraCintas.push_back(simbolo);
     movimientoCintas.push_back(movimiento);
   }
 
   // Compruebo que el/los estado/s final no tiene/n transiciones
-  for (Estado* e : datos.estados) {
-    if (e->getId() == actual && e->esAceptacion()) {
-      throw runtime_error("El estado " + actual + " es de aceptación y no puede tener transiciones.");
-    }
+  Estado* estadoActual = buscarEstado(actual);
+  if (estadoActual != nullptr && estadoActual->esAceptacion()) {
+    throw runtime_error("El estado " + actual + " es de aceptación y no puede tener transiciones.");
   }
   // Compruebo los estados
   comprobarEstado(actual), comprobarEstado(siguiente);
-  // Busco el estado inicial y siguiente en el conjunto de estados
-  Estado* estadoSiguiente = buscarEstado(siguiente), *estadoActual = buscarEstado(actual);
+  // Busco el estado siguiente en el conjunto de estados
+  Estado* estadoSiguiente = buscarEstado(siguiente);
+  if (receptor) {
+    receptor(TransicionLeida{id, estadoActual, lecturaCintas, estadoSiguiente, escrituraCintas, movimientoCintas});
+    return;
+  }
   // Creo la transición y la agrego la transicion
-  Transicion transicion(id, estadoActual, lecturaCintas, estadoSiguiente, escrituraCintas, movimientoCintas);
+  Transicion transicion(id, estadoActual, lecturaCintas, estadoSiguiente, escrituraCintas, movimientoCintas, datos.simbolos.get());
   
-  buscarEstado(actual)->agregarTransicion(transicion);
+  estadoActual->agregarTransicion(transicion);
+}
+
+/**
+ * @brief Función para leer un símbolo de una transición. Con la codificación directa se lee un
+ *        carácter, como siempre; si hay símbolos de varios caracteres se lee una palabra.
+ * @param is Stream de entrada
+ * @return Texto del símbolo
+ */
+string leerSimbolo(istringstream& is) {
+  if (datos.simbolos->directa()) {
+    char simbolo = '\0';
+    is >> simbolo;
+    return string(1, simbolo);
+  }
+  string simbolo;
+  is >> simbolo;
+  return simbolo;
 }
 
 /**
@@ -164,14 +262,11 @@ void leerTransiciones(istringstream is, int id, int numCintas) {
  * @param numCintas Número de cintas
  * @return Vector con los simbolos de lectura de las cintas
  */
-vector<char> leerSimbolosLectura(istringstream& is, int numCintas) {
-  vector<char> lecturaCintas;
+vector<Simbolo> leerSimbolosLectura(istringstream& is, int numCintas) {
+  vector<Simbolo> lecturaCintas;
   lecturaCintas.resize(numCintas);
   for (int i = 0; i < numCintas; ++i) {
-    char simbolo;
-    is >> simbolo;
-    comprobarSimboloCinta(simbolo);
-    lecturaCintas[i] = simbolo;
+    lecturaCintas[i] = comprobarSimboloCinta(leerSimbolo(is));
   }
   return lecturaCintas;
 }
@@ -182,13 +277,13 @@ vector<char> leerSimbolosLectura(istringstream& is, int numCintas) {
  * @param numCintas Número de cintas
  * @return Vector con los movimientos de las cintas
  */
-vector<pair<char, char>> leerMovimientos(istringstream& is, int numCintas) {
-  vector<pair<char, char>> movimientos;
+vector<pair<Simbolo, char>> leerMovimientos(istringstream& is, int numCintas) {
+  vector<pair<Simbolo, char>> movimientos;
   movimientos.resize(numCintas);
   for (int i = 0; i < numCintas; ++i) {
-    char simbolo, movimiento;
-    is >> simbolo >> movimiento;
-    comprobarSimboloCinta(simbolo);
+    Simbolo simbolo = comprobarSimboloCinta(leerSimbolo(is));
+    char movimiento;
+    is >> movimiento;
     comprobarEscrituraLectura(movimiento);
     movimientos[i] = make_pair(simbolo, movimiento);
   }
@@ -201,12 +296,8 @@ vector<pair<char, char>> leerMovimientos(istringstream& is, int numCintas) {
  * @return Puntero al estado si se encuentra, nullptr en caso contrario
  */
 Estado* buscarEstado(const string& estado) {
-  for (Estado* e : datos.estados) {
-    if (e->getId() == estado) {
-      return e;
-    }
-  }
-  return nullptr;
+  auto it = indiceEstados.find(estado);
+  return it != indiceEstados.end() ? it->second : nullptr;
 }
 
 
@@ -217,12 +308,7 @@ Estado* buscarEstado(const string& estado) {
  * @return void
  */
 void comprobarEstado(const string& estado) {
-  bool encontrado = false;
-  for (Estado* e : datos.estados) {
-    if (e->getId() == estado) {
-      encontrado = true;
-    }
-  }
+  bool encontrado = buscarEstado(estado) != nullptr;
 
   if (!encontrado) {
     cerr << "Q -> {";
@@ -238,14 +324,16 @@ void comprobarEstado(const string& estado) {
 }
 
 /**
- * @brief Comprueba que un símbolo pertenece al alfabeto de entrada (Σ)
+ * @brief Comprueba que un símbolo pertenece al alfabeto de la cinta (Γ) y obtiene su código
  */
-void comprobarSimboloCinta(const char& simbolo) {
-  if (simbolo == '.') return; // epsilon siempre permitido en lectura de cadena
-  if (!datos.alfabetos.second.pertenece(simbolo)) {
+Simbolo comprobarSimboloCinta(const string& simbolo) {
+  if (simbolo == ".") return '.'; // epsilon siempre permitido en lectura de cadena
+  Simbolo codigo;
+  if (!datos.simbolos->buscar(simbolo, codigo) || !datos.alfabetos.second.pertenece(codigo)) {
     cerr << "Γ -> " << datos.alfabetos.second << endl;
-    throw runtime_error(string("El símbolo '") + simbolo + "' no pertenece al alfabeto de la cinta (Γ).");
+    throw runtime_error("El símbolo '" + simbolo + "' no pertenece al alfabeto de la cinta (Γ).");
   }
+  return codigo;
 }
 
 /**
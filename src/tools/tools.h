@@ -5,6 +5,7 @@
 #include <fstream> // Para manejo de archivos
 #include <stdexcept> // Para las excepciones
 #include <sstream> // Para istringstream
+#include <functional> // Para std::function
 
 #ifndef TOOLS_H
 #define TOOLS_H
@@ -15,20 +16,39 @@
  */
 struct Tools {
   pair<Alfabeto, Alfabeto> alfabetos;
+  shared_ptr<const TablaSimbolos> simbolos; // Códigos de los símbolos de Σ y Γ
   vector<Estado*> estados;
   int numCintas = 1;
 };
 
+/**
+ * @struct TransicionLeida
+ * @brief Transición ya validada, tal y como se lee del fichero
+ */
+struct TransicionLeida {
+  int id;
+  Estado* actual;
+  vector<Simbolo> lectura;
+  Estado* siguiente;
+  vector<Simbolo> escritura;
+  vector<char> movimiento;
+};
+
+using ReceptorTransiciones = function<void(const TransicionLeida&)>;
+
 Tools leerFichero(const string& nombreFichero); // Leo el fichero para obtener los datos
+Tools leerFlujo(istream& file, const ReceptorTransiciones& receptor = nullptr); // Leo los datos desde un flujo cualquiera
+void liberarEstados(Tools& datos); // Libero los estados leídos
 void leerEstados(istringstream is); // Leo los estados del fichero
 void leerEstadosFinales(istringstream is); // Leo los estados finales del fichero
-void leerAlfabeto(istringstream is); // Leo el alfabeto del fichero
-void leerTransiciones(istringstream is, int id, int numCintas); // Leo las transiciones del fichero
+void leerAlfabetos(istringstream entrada, istringstream cinta); // Leo los alfabetos del fichero e interno sus símbolos
+void leerTransiciones(istringstream is, int id, int numCintas, const ReceptorTransiciones& receptor); // Leo las transiciones del fichero
 void comprobarEstado(const string& estado); // Compruebo que el estado es válido
-void comprobarSimboloCinta(const char& simbolo); // Compruebo que el símbolo es válido
+Simbolo comprobarSimboloCinta(const string& simbolo); // Compruebo que el símbolo es válido y obtengo su código
 void comprobarEscrituraLectura(const char& simbolo); // Compruebo que el símbolo es de escritura/lectura válido
-vector<char> leerSimbolosLectura(istringstream& is, int numCintas); // Leo los simbolos de lectura de las cintas
-vector<pair<char, char>> leerMovimientos(istringstream& is, int numCintas); // Leo los movimientos junto con los simbolos de escritura
+string leerSimbolo(istringstream& is); // Leo un símbolo de una transición
+vector<Simbolo> leerSimbolosLectura(istringstream& is, int numCintas); // Leo los simbolos de lectura de las cintas
+vector<pair<Simbolo, char>> leerMovimientos(istringstream& is, int numCintas); // Leo los movimientos junto con los simbolos de escritura
 Estado* buscarEstado(const string& estado); // Buscar un estado en el conjunto de estados
 
 #endif // TOOLS_H
\ No newline at end of file
@@ -9,14 +9,16 @@
  * @param siguiente Estado al cual se transita
  * @param escrituraCinta Símbolo que se escribe en la cinta
  * @param movimientoCinta Movimiento de la cabeza de la cinta ('L' para izquierda, 'R' para derecha)
+ * @param simbolos Tabla de símbolos de la máquina
  */
-Transicion::Transicion(const int& id, Estado* actual, const vector<char>& lecturaCinta, Estado* siguiente, const vector<char>& escrituraCinta, const vector<char>& movimientoCinta) {
+Transicion::Transicion(const int& id, Estado* actual, const vector<Simbolo>& lecturaCinta, Estado* siguiente, const vector<Simbolo>& escrituraCinta, const vector<char>& movimientoCinta, const TablaSimbolos* simbolos) {
   id_ = id;
   actual_ = actual;
   lecturaCintas_ = lecturaCinta;
   siguiente_ = siguiente;
   escrituraCintas_ = escrituraCinta;
   movimientoCintas_ = movimientoCinta;
+  simbolos_ = simbolos;
 }
 
 /**
@@ -47,7 +49,7 @@ Estado* Transicion::ejecutar(vector<Cinta>& cintas) {
  * @param simbolosLeidos Símbolos leídos en las cintas
  * @return true si la transición es aplicable, false en caso contrario
  */
-bool Transicion::esAplicable(const vector<char>& simbolosLeidos) const {
+bool Transicion::esAplicable(const vector<Simbolo>& simbolosLeidos) const {
   for (size_t i = 0; i < lecturaCintas_.size(); ++i) {
     if (lecturaCintas_[i] == simbolosLeidos[i]) {
       continue;
@@ -64,7 +66,7 @@ ostream& operator<<(ostream& os, const Transicion& transicion) {
   os << "δ(" << transicion.actual_->getId() << ", ";
   // Muestro los simbolos de lectura
   for (size_t i = 0; i < transicion.lecturaCintas_.size(); ++i) {
-    os << transicion.lecturaCintas_[i];
+    os << transicion.simbolos_->token(transicion.lecturaCintas_[i]);
     if (i < transicion.lecturaCintas_.size() - 1) {
       os << ",";
     }
@@ -72,7 +74,7 @@ ostream& operator<<(ostream& os, const Transicion& transicion) {
   os << ") -> (" << transicion.siguiente_->getId() << ", ";
   // Muestro los simbolos de escritura
   for (size_t i = 0; i < transicion.escrituraCintas_.size(); ++i) {
-    os << transicion.escrituraCintas_[i];
+    os << transicion.simbolos_->token(transicion.escrituraCintas_[i]);
     if (i < transicion.escrituraCintas_.size() - 1) {
       os << ",";
     }
@@ -18,26 +18,31 @@ class Transicion {
   public:
     // Constructor y destructor
     Transicion() = default;
-    Transicion(const int& id, Estado* actual, const vector<char>& lecturaCinta, Estado* siguiente, const vector<char>& escrituraCinta, const vector<char>& movimientoCinta);
+    Transicion(const int& id, Estado* actual, const vector<Simbolo>& lecturaCinta, Estado* siguiente, const vector<Simbolo>& escrituraCinta, const vector<char>& movimientoCinta, const TablaSimbolos* simbolos);
     ~Transicion() = default;
 
     // Getters
     inline int getId() const { return id_; }
+    inline const vector<Simbolo>& getLectura() const { return lecturaCintas_; }
+    inline const vector<Simbolo>& getEscritura() const { return escrituraCintas_; }
+    inline const vector<char>& getMovimientos() const { return movimientoCintas_; }
+    inline Estado* getSiguiente() const { return siguiente_; }
 
     // Métodos
     Estado* ejecutar(vector<Cinta>& cintas);
-    bool esAplicable(const vector<char>& simbolosLeidos) const; // Comprobar si la transicion es aplicable
+    bool esAplicable(const vector<Simbolo>& simbolosLeidos) const; // Comprobar si la transicion es aplicable
 
     // Sobrecarga de operadores
     friend ostream& operator<<(ostream& os, const Transicion& transicion);
 
   private:
     int id_;
-    vector<char> lecturaCintas_;
-    vector<char> escrituraCintas_;
+    vector<Simbolo> lecturaCintas_;
+    vector<Simbolo> escrituraCintas_;
     vector<char> movimientoCintas_; // 'L' (izquierda), 'R' (derecha), 'S' (sin movimiento)
     Estado* actual_;
     Estado* siguiente_;
+    const TablaSimbolos* simbolos_; // Para mostrar los símbolos, pertenece a la máquina
 };
 
 #endif // TRANSICION_H
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "tuberia.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception> // Para exception_ptr
+#include <mutex>
+#include <optional>
+#include <sstream> // Para ostringstream
+#include <stdexcept> // Para las excepciones
+#include <thread>
+
+/**
+ * @struct Trabajo
+ * @brief Entrada del lote que avanza por la tubería llevando su cinta
+ */
+struct Trabajo {
+  explicit Trabajo(size_t indice = 0) : indice(indice) {}
+
+  size_t indice;
+  long pasos = 0;
+  CintaSegmentada<char> cinta;          // Salida traspasada de la etapa anterior (símbolos de 8 bits)
+  CintaSegmentada<uint16_t> cintaAncha; // Salida traspasada de la etapa anterior (símbolos de 16 bits)
+  string texto;                         // Salida de la etapa anterior si tiene otros símbolos
+};
+
+/**
+ * @class ColaTrabajos
+ * @brief Cola acotada entre dos etapas de la tubería. Al cerrarla, quien extrae recibe los
+ *        trabajos que quedan y después nullopt, y quien inserta deja de esperar
+ */
+class ColaTrabajos {
+  public:
+    explicit ColaTrabajos(size_t capacidad) : capacidad_(capacidad) {}
+
+    bool insertar(Trabajo&& trabajo) { // false si la cola está cerrada
+      unique_lock<mutex> lock(mutex_);
+      hayHueco_.wait(lock, [this] { return cola_.size() < capacidad_ || cerrada_; });
+      if (cerrada_) {
+        return false;
+      }
+      cola_.push_back(std::move(trabajo));
+      hayTrabajo_.notify_one();
+      return true;
+    }
+
+    optional<Trabajo> extraer() {
+      unique_lock<mutex> lock(mutex_);
+      hayTrabajo_.wait(lock, [this] { return !cola_.empty() || cerrada_; });
+      if (cola_.empty()) {
+        return nullopt;
+      }
+      Trabajo trabajo = std::move(cola_.front());
+      cola_.pop_front();
+      hayHueco_.notify_one();
+      return trabajo;
+    }
+
+    void cerrar() {
+      lock_guard<mutex> lock(mutex_);
+      cerrada_ = true;
+      hayTrabajo_.notify_all();
+      hayHueco_.notify_all();
+    }
+
+  private:
+    deque<Trabajo> cola_;
+    size_t capacidad_;
+    bool cerrada_ = false;
+    mutex mutex_;
+    condition_variable hayTrabajo_;
+    condition_variable hayHueco_;
+};
+
+/**
+ * @brief Ejecuta una etapa, salvo la primera, sobre la salida de la anterior
+ * @param etapa Máquina de la etapa
+ * @param traspasada Si la salida anterior llega como cinta (mismos símbolos) o como texto
+ * @param trabajo Trabajo con la salida de la etapa anterior
+ * @param contexto Memoria de trabajo de la etapa
+ * @param opciones Opciones de la ejecución
+ * @return Resultado de la etapa
+ */
+static Resultado ejecutarEtapa(const Motor& etapa, bool traspasada, Trabajo& trabajo, Contexto& contexto, const Opciones& opciones) {
+  if (!traspasada) {
+    return etapa.ejecutar(trabajo.texto, contexto, opciones);
+  }
+  if (etapa.tablaSimbolos().anchura() == 1) {
+    return etapa.ejecutarCinta(trabajo.cinta, contexto, opciones);
+  }
+  return etapa.ejecutarCinta(trabajo.cintaAncha, contexto, opciones);
+}
+
+/**
+ * @brief Guarda en el trabajo la cinta de salida de una etapa para la siguiente
+ * @param etapa Máquina de la etapa
+ * @param cinta Cinta de salida (empezando en 0)
+ * @param traspasar Si la cinta se traspasa sin copiarla o se pasa como texto
+ * @param trabajo Trabajo que pasa a la siguiente etapa
+ * @param contexto Memoria de trabajo de la etapa
+ * @return void
+ */
+static void recogerSalida(const Motor& etapa, size_t cinta, bool traspasar, Trabajo& trabajo, Contexto& contexto) {
+  if (!traspasar) {
+    trabajo.texto = contexto.contenidoCinta(cinta);
+  } else if (etapa.tablaSimbolos().anchura() == 1) {
+    contexto.tomarCinta(cinta, trabajo.cinta);
+  } else {
+    contexto.tomarCinta(cinta, trabajo.cintaAncha);
+  }
+}
+
+/**
+ * @brief Constructor de la clase Tuberia
+ * @param etapas Máquinas de cada etapa, en orden
+ * @param cintasSalida Cinta (empezando en 0) de cada etapa que pasa a la siguiente
+ */
+Tuberia::Tuberia(vector<Motor> etapas, vector<size_t> cintasSalida) : etapas_(std::move(etapas)), cintasSalida_(std::move(cintasSalida)) {
+  if (etapas_.empty() || etapas_.size() != cintasSalida_.size()) {
+    throw invalid_argument("La tubería necesita al menos una etapa y una cinta de salida por etapa.");
+  }
+  for (size_t i = 0; i < etapas_.size(); ++i) {
+    if (cintasSalida_[i] >= static_cast<size_t>(etapas_[i].numCintas())) {
+      throw invalid_argument("La etapa " + to_string(i + 1) + " no tiene la cinta " + to_string(cintasSalida_[i] + 1) + ".");
+    }
+    traspasar_.push_back(i + 1 < etapas_.size() && etapas_[i].tablaSimbolos() == etapas_[i + 1].tablaSimbolos());
+  }
+}
+
+/**
+ * @brief Carga las etapas de la tubería desde ficheros
+ * @param especificaciones "fichero" (salida en la cinta 1) o "fichero:cinta" por cada etapa
+ * @return Tubería cargada
+ */
+Tuberia Tuberia::desdeFicheros(const vector<string>& especificaciones) {
+  vector<Motor> etapas;
+  vector<size_t> cintasSalida;
+  for (const string& especificacion : especificaciones) {
+    size_t separador = especificacion.rfind(':');
+    size_t cinta = 1;
+    string fichero = especificacion;
+    if (separador != string::npos) {
+      cinta = stoul(especificacion.substr(separador + 1));
+      fichero = especificacion.substr(0, separador);
+    }
+    if (cinta == 0) {
+      throw invalid_argument("Las cintas se numeran empezando en 1: " + especificacion);
+    }
+    etapas.push_back(Motor::desdeFichero(fichero));
+    cintasSalida.push_back(cinta - 1);
+  }
+  return Tuberia(std::move(etapas), std::move(cintasSalida));
+}
+
+/**
+ * @brief Método para pasar una entrada por todas las etapas, una detrás de otra
+ * @param entrada Cadena de entrada de la primera etapa
+ * @param opciones Opciones de cada etapa (el límite de pasos es por etapa)
+ * @return Resultado de la tubería
+ */
+ResultadoTuberia Tuberia::ejecutar(string_view entrada, const Opciones& opciones) const {
+  ResultadoTuberia resultado;
+  Contexto contexto;
+  Trabajo trabajo{0};
+  for (size_t i = 0; i < etapas_.size(); ++i) {
+    Resultado parcial = i == 0 ? etapas_[i].ejecutar(entrada, contexto, opciones) : ejecutarEtapa(etapas_[i], traspasar_[i - 1], trabajo, contexto, opciones);
+    resultado.etapa = i;
+    resultado.pasos += parcial.pasos;
+    resultado.veredicto = parcial.veredicto;
+    if (parcial.veredicto != Veredicto::Aceptada) {
+      return resultado;
+    }
+    recogerSalida(etapas_[i], cintasSalida_[i], traspasar_[i], trabajo, contexto);
+  }
+  resultado.salida = std::move(trabajo.texto);
+  return resultado;
+}
+
+/**
+ * @brief Método para pasar un lote de entradas por la tubería con un hilo por etapa, de forma
+ *        que todas las etapas trabajan a la vez sobre entradas distintas. Si una etapa lanza una
+ *        excepción, se detienen todas y se relanza la de la primera etapa que falló. Con
+ *        Opciones::volcadoRegistro, cada etapa vuelca su registro de vuelo en un buffer propio y
+ *        lo escribe entero en el flujo mientras tiene el cerrojo, precedido de la etapa y la entrada.
+ * @param entradas Cadenas de entrada
+ * @param opciones Opciones de cada etapa (el límite de pasos es por etapa)
+ * @return Resultados en el mismo orden que las entradas
+ */
+vector<ResultadoTuberia> Tuberia::ejecutarLote(const vector<string>& entradas, const Opciones& opciones) const {
+  vector<ResultadoTuberia> resultados(entradas.size());
+  vector<unique_ptr<ColaTrabajos>> colas; // colas[i] alimenta a la etapa i + 1
+  for (size_t i = 0; i + 1 < etapas_.size(); ++i) {
+    colas.push_back(make_unique<ColaTrabajos>(64));
+  }
+  vector<exception_ptr> errores(etapas_.size());
+  atomic<bool> fallo{false};
+  mutex volcadoMutex; // Los volcados de las etapas comparten opciones.volcadoRegistro
+
+  auto etapa = [&](size_t i) {
+    try {
+      Contexto contexto;
+      Opciones opcionesEtapa = opciones;
+      opcionesEtapa.volcadoRegistro = nullptr; // La etapa vuelca el registro en su buffer
+      auto procesar = [&](Trabajo& trabajo, const Resultado& parcial) {
+        ResultadoTuberia& resultado = resultados[trabajo.indice];
+        trabajo.pasos += parcial.pasos;
+        bool conRegistro = parcial.veredicto != Veredicto::Aceptada && parcial.veredicto != Veredicto::EntradaInvalida;
+        if (opciones.volcadoRegistro != nullptr && conRegistro && contexto.registroVuelo().activo()) {
+          ostringstream volcado;
+          volcado << "Etapa " << i + 1 << ", entrada " << trabajo.indice + 1 << ":" << endl;
+          etapas_[i].volcarRegistro(contexto, volcado);
+          lock_guard<mutex> lock(volcadoMutex);
+          *opciones.volcadoRegistro << volcado.str();
+        }
+        if (parcial.veredicto != Veredicto::Aceptada || i + 1 == etapas_.size()) {
+          resultado = ResultadoTuberia{parcial.veredicto, i, trabajo.pasos, ""};
+          if (parcial.veredicto == Veredicto::Aceptada) {
+            resultado.salida = contexto.contenidoCinta(cintasSalida_[i]);
+          }
+          return;
+        }
+        recogerSalida(etapas_[i], cintasSalida_[i], traspasar_[i], trabajo, contexto);
+        colas[i]->insertar(std::move(trabajo)); // Solo se rechaza si otra etapa ha fallado
+      };
+
+      if (i == 0) {
+        for (size_t j = 0; j < entradas.size() && !fallo; ++j) {
+          Trabajo trabajo{j};
+          procesar(trabajo, etapas_[0].ejecutar(entradas[j], contexto, opcionesEtapa));
+        }
+      } else {
+        while (optional<Trabajo> trabajo = colas[i - 1]->extraer()) {
+          if (fallo) {
+            break;
+          }
+          procesar(*trabajo, ejecutarEtapa(etapas_[i], traspasar_[i - 1], *trabajo, contexto, opcionesEtapa));
+        }
+      }
+    } catch (...) {
+      errores[i] = current_exception();
+      fallo = true;
+      // Cierro todas las colas: las etapas que esperan hueco o trabajo dejan de esperar y, al
+      // ver el fallo, terminan sin que ninguna se quede bloqueada en una cola que nadie vacía
+      for (const unique_ptr<ColaTrabajos>& cola : colas) {
+        cola->cerrar();
+      }
+    }
+    if (i < colas.size()) {
+      colas[i]->cerrar();
+    }
+  };
+
+  vector<thread> hilos;
+  for (size_t i = 0; i < etapas_.size(); ++i) {
+    hilos.emplace_back(etapa, i);
+  }
+  for (thread& hilo : hilos) {
+    hilo.join();
+  }
+  for (const exception_ptr& error : errores) {
+    if (error) {
+      rethrow_exception(error);
+    }
+  }
+  return resultados;
+}
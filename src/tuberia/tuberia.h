@@ -0,0 +1,48 @@
+#pragma once
+#include "../motor/motor.h"
+#include <string>
+#include <vector>
+
+#ifndef TUBERIA_H
+#define TUBERIA_H
+
+using namespace std;
+
+/**
+ * @struct ResultadoTuberia
+ * @brief Resultado de pasar una entrada por todas las etapas de una tubería
+ */
+struct ResultadoTuberia {
+  Veredicto veredicto = Veredicto::Rechazada; // Aceptada solo si todas las etapas aceptan
+  size_t etapa = 0;                           // Última etapa ejecutada (empezando en 0)
+  long pasos = 0;                             // Pasos sumados de todas las etapas ejecutadas
+  string salida;                              // Salida de la última etapa si todas aceptan
+};
+
+/**
+ * @class Tuberia
+ * @brief Cadena de máquinas en la que la cinta de salida de cada etapa es la entrada de la
+ *        siguiente. Si dos etapas seguidas tienen los mismos símbolos, la cinta se traspasa sin
+ *        copiar sus celdas; si no, se pasa como texto y se codifica con los de la siguiente.
+ */
+class Tuberia {
+  public:
+    // Constructor y destructor
+    Tuberia(vector<Motor> etapas, vector<size_t> cintasSalida);
+    ~Tuberia() = default;
+
+    // Carga de las etapas a partir de "fichero" o "fichero:cinta" (cinta de salida empezando en 1)
+    static Tuberia desdeFicheros(const vector<string>& especificaciones);
+
+    // Métodos
+    ResultadoTuberia ejecutar(string_view entrada, const Opciones& opciones = {}) const;
+    vector<ResultadoTuberia> ejecutarLote(const vector<string>& entradas, const Opciones& opciones = {}) const;
+    inline size_t numEtapas() const { return etapas_.size(); }
+
+  private:
+    vector<Motor> etapas_;
+    vector<size_t> cintasSalida_; // Cinta de cada etapa que pasa a la siguiente (empezando en 0)
+    vector<bool> traspasar_;      // Si la salida de cada etapa se traspasa como cinta a la siguiente
+};
+
+#endif // TUBERIA_H